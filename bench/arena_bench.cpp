@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "arena.hpp"
+#include "bench.hpp"
+#include "neuron.hpp"
+#include "value.hpp"
+
+// A neuron with its parameters and an input vector reused across steps, so allocs/step counts only graph nodes
+struct Model {
+    Neuron neuron;
+    std::vector<Value> weights;  // The bias last
+    std::vector<Value> inputs;
+
+    explicit Model(size_t input_size) : neuron(input_size), weights(neuron.parameters()) {
+        inputs.reserve(input_size);
+    }
+};
+
+// One training step of the neuron: fresh inputs, one fused linear node, backward
+static void neuron_step(Model& model, size_t input_size) {
+    for (size_t i = 0; i < input_size; ++i) {
+        model.inputs.emplace_back(0.001 * static_cast<double>(i));
+    }
+    Value out = model.neuron(model.inputs);
+    out.backward();
+    model.inputs.clear();
+}
+
+// The same dot product as a chain of binary ops, two interior nodes (each with its own children) per input
+static void chain_step(Model& model, size_t input_size) {
+    for (size_t i = 0; i < input_size; ++i) {
+        model.inputs.emplace_back(0.001 * static_cast<double>(i));
+    }
+    Value out = model.weights[input_size];
+    for (size_t i = 0; i < input_size; ++i) {
+        out = out + model.weights[i] * model.inputs[i];
+    }
+    out.backward();
+    model.inputs.clear();
+}
+
+int main() {
+    std::printf("%-8s %-8s %-6s %14s %14s\n", "graph", "inputs", "path", "allocs/step", "ns/step");
+    for (auto [name, step] : {std::pair{"neuron", &neuron_step}, std::pair{"chain", &chain_step}}) {
+        for (size_t input_size : {10, 100, 1000}) {
+            Model model(input_size);
+            const size_t steps = 20000 / input_size + 10;
+            auto heap_step = [&] { step(model, input_size); };
+            size_t before = allocation_count();
+            double heap_ns = time_per_call_ns(heap_step, steps);
+            double heap_allocs = static_cast<double>(allocation_count() - before) / static_cast<double>(steps);
+
+            GraphArena arena;
+            auto arena_step = [&] {
+                NoLeakScope scope(arena);
+                step(model, input_size);
+            };
+            arena_step();  // warm up the arena blocks
+            before = allocation_count();
+            double arena_ns = time_per_call_ns(arena_step, steps);
+            double arena_allocs = static_cast<double>(allocation_count() - before) / static_cast<double>(steps);
+
+            std::printf("%-8s %-8zu %-6s %14.1f %14.0f\n", name, input_size, "heap", heap_allocs, heap_ns);
+            std::printf("%-8s %-8zu %-6s %14.1f %14.0f\n", name, input_size, "arena", arena_allocs, arena_ns);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "neuron.hpp"
+#include "simd.hpp"
+#include "value.hpp"
+
+namespace {
+
+template <typename T>
+void run(const char* type, size_t input_size, size_t rows) {
+    using Scalar = typename BasicValue<T>::Scalar;
+    BasicNeuron<T> neuron(input_size);
+    std::vector<Scalar> inputs(rows * input_size);
+    for (size_t i = 0; i < inputs.size(); ++i) inputs[i] = Scalar(std::sin(0.001 * static_cast<double>(i)));
+    std::vector<Scalar> outputs(rows);
+    std::vector<Scalar> output_grads(rows, Scalar(1));
+
+    auto report = [&](const char* mode, double ns_per_batch) {
+        std::printf("%-6s %-6zu %-18s %14.1f\n", type, input_size, mode, ns_per_batch / static_cast<double>(rows));
+    };
+
+    // Per-sample graph path, on a slice of the rows to keep the run short
+    const size_t sample_rows = rows / 10;
+    std::vector<BasicValue<T>> x;
+    for (size_t i = 0; i < input_size; ++i) x.emplace_back(Scalar(0), false);
+    report("per-sample Value", 10 * time_per_call_ns(
+                                        [&] {
+                                            for (size_t r = 0; r < sample_rows; ++r) {
+                                                for (size_t i = 0; i < input_size; ++i) {
+                                                    x[i].set_data(inputs[r * input_size + i]);
+                                                }
+                                                outputs[r] = neuron(x).data();
+                                            }
+                                        },
+                                        3));
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (static_cast<int>(level) > static_cast<int>(supported_simd_level())) continue;
+        set_simd_level(level);
+        char mode[32];
+        std::snprintf(mode, sizeof(mode), "batch %s", simd_level_name(level));
+        report(mode, time_per_call_ns([&] { neuron.forward_batch(inputs.data(), rows, outputs.data()); }, 10));
+        std::snprintf(mode, sizeof(mode), "batch+grad %s", simd_level_name(level));
+        report(mode, time_per_call_ns(
+                         [&] {
+                             neuron.forward_batch(inputs.data(), rows, outputs.data());
+                             neuron.backward_batch(inputs.data(), rows, outputs.data(), output_grads.data());
+                         },
+                         10));
+    }
+    set_simd_level(supported_simd_level());
+}
+
+}  // namespace
+
+// Scoring throughput of one neuron over a row-major input matrix: per-sample Values against the batch API
+// with each kernel the CPU supports
+int main() {
+    std::printf("detected: %s\n", simd_level_name(supported_simd_level()));
+    std::printf("%-6s %-6s %-18s %14s\n", "type", "dim", "mode", "ns/row");
+    for (size_t input_size : {16, 128, 1024}) {
+        const size_t rows = 4000000 / input_size;
+        run<double>("double", input_size, rows);
+        run<float>("float", input_size, rows);
+    }
+    return 0;
+}
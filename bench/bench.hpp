@@ -0,0 +1,21 @@
+#ifndef CPPGRAD_BENCH_HPP
+#define CPPGRAD_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+
+// Number of calls to the global operator new since program start (see alloc_counter.cpp)
+size_t allocation_count() noexcept;
+
+// Runs fn `iterations` times and returns the mean wall time per call in nanoseconds
+template <typename Fn>
+double time_per_call_ns(Fn&& fn, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+#endif  // CPPGRAD_BENCH_HPP
@@ -0,0 +1,36 @@
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "data_parallel.hpp"
+#include "mlp.hpp"
+#include "tensor.hpp"
+
+// Samples per second of data-parallel forward/backward/reduce as the worker count grows
+int main() {
+    const size_t batch = 1024;
+    const size_t input = 64;
+    MLP model(input, {256, 256, 10});
+
+    std::vector<double> x(batch * input);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<double>(i % 13) / 13.0 - 0.5;
+    }
+    auto loss_fn = [&](const MLP& m, size_t begin, size_t end) {
+        Tensor shard({end - begin, input}, std::vector<double>(x.begin() + static_cast<std::ptrdiff_t>(begin * input),
+                                                               x.begin() + static_cast<std::ptrdiff_t>(end * input)));
+        return m(shard).pow(2.0).sum();
+    };
+
+    const size_t max_workers = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%-10s %14s %14s %10s\n", "workers", "ms/step", "samples/s", "speedup");
+    double baseline = 0.0;
+    for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+        DataParallelTrainer trainer(model, workers);
+        double ns = time_per_call_ns([&] { trainer.accumulate_gradients(batch, loss_fn); }, 10);
+        if (workers == 1) baseline = ns;
+        std::printf("%-10zu %14.3f %14.0f %10.2f\n", workers, ns * 1e-6, batch / (ns * 1e-9), baseline / ns);
+    }
+    return 0;
+}
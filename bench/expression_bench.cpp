@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "expression.hpp"
+#include "value.hpp"
+
+namespace {
+
+// Typical per-sample losses, written once and evaluated either per op or fused through lazy()
+struct SquaredError {
+    const char* name = "squared error";
+    template <typename P, typename Y>
+    static Value loss(const P& prediction, const Y& target, const Value&) {
+        return (prediction - target).pow(2.0);
+    }
+};
+
+struct HingeLoss {
+    const char* name = "hinge";
+    template <typename P, typename Y>
+    static Value loss(const P& prediction, const Y& target, const Value& one) {
+        return (one - prediction * target).relu();
+    }
+};
+
+struct RelativeError {
+    const char* name = "relative error";
+    template <typename P, typename Y>
+    static Value loss(const P& prediction, const Y& target, const Value& one) {
+        return ((prediction - target) / (target * target + one)).pow(2.0) + (prediction * prediction) / target;
+    }
+};
+
+}  // namespace
+
+// Forward and backward of a loss summed over a batch: the per-op graph against one fused node per sample
+int main() {
+    constexpr size_t batch = 256;
+    constexpr size_t steps = 2000;
+    std::vector<Value> predictions;
+    std::vector<Value> targets;
+    for (size_t i = 0; i < batch; ++i) {
+        predictions.emplace_back(0.01 * static_cast<double>(i) - 1.0);
+        targets.emplace_back(0.5 + 0.002 * static_cast<double>(i));
+    }
+    const Value one(1.0);
+
+    std::printf("%-16s %-8s %14s %14s\n", "loss", "mode", "allocs/step", "us/step");
+    auto run = [&](auto loss_fn) {
+        using Loss = decltype(loss_fn);
+        auto report = [&](const char* mode, auto&& step) {
+            step();
+            size_t before = allocation_count();
+            double ns = time_per_call_ns(step, steps);
+            double allocs = static_cast<double>(allocation_count() - before) / static_cast<double>(steps);
+            std::printf("%-16s %-8s %14.1f %14.2f\n", loss_fn.name, mode, allocs, ns / 1000.0);
+        };
+        report("per-op", [&] {
+            Value total(0.0);
+            for (size_t i = 0; i < batch; ++i) {
+                total = total + Loss::loss(predictions[i], targets[i], one);
+            }
+            total.backward();
+        });
+        report("fused", [&] {
+            Value total(0.0);
+            for (size_t i = 0; i < batch; ++i) {
+                total = total + Loss::loss(lazy(predictions[i]), targets[i], one);
+            }
+            total.backward();
+        });
+    };
+    run(SquaredError{});
+    run(HingeLoss{});
+    run(RelativeError{});
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+#include "arena.hpp"
+#include "bench.hpp"
+#include "neuron.hpp"
+#include "value.hpp"
+
+// Forward + backward of one ReLU neuron, either as a chain of scalar ops or as one fused node
+static size_t neuron_step(std::vector<Value>& weights, std::vector<Value>& inputs, bool fused) {
+    GraphArena arena;
+    NoLeakScope scope(arena);
+    size_t before = arena.live_allocations();
+    Value out = fused ? Value::linear(weights, inputs, true)
+                      : std::inner_product(weights.begin(), weights.end() - 1, inputs.begin(), weights.back()).relu();
+    size_t nodes = arena.live_allocations() - before;
+    out.backward();
+    return nodes;
+}
+
+int main() {
+    std::printf("%-8s %-8s %10s %14s %14s\n", "inputs", "path", "nodes", "allocs/step", "ns/step");
+    for (size_t input_size : {10, 100, 1000, 10000}) {
+        Neuron neuron(input_size);
+        std::vector<Value> weights = neuron.parameters();
+        std::vector<Value> inputs;
+        for (size_t i = 0; i < input_size; ++i) {
+            inputs.emplace_back(0.001 * static_cast<double>(i));
+        }
+        const size_t steps = 200000 / input_size + 10;
+
+        for (bool fused : {false, true}) {
+            size_t nodes = neuron_step(weights, inputs, fused);
+            size_t before = allocation_count();
+            double ns = time_per_call_ns([&] { neuron_step(weights, inputs, fused); }, steps);
+            double allocs = static_cast<double>(allocation_count() - before) / static_cast<double>(steps);
+            std::printf("%-8zu %-8s %10zu %14.1f %14.0f\n", input_size, fused ? "fused" : "unfused", nodes, allocs, ns);
+        }
+    }
+    return 0;
+}
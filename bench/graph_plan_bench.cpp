@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "graph_plan.hpp"
+#include "neuron.hpp"
+#include "value.hpp"
+
+// One training step of a 8-16-1 network of Neurons over a minibatch: rebuilding the graph every step
+// against replaying a captured plan with new inputs
+int main() {
+    constexpr size_t input_size = 8;
+    constexpr size_t hidden_size = 16;
+    constexpr size_t steps = 200;
+
+    std::vector<Neuron> hidden;
+    for (size_t i = 0; i < hidden_size; ++i) hidden.emplace_back(input_size);
+    Neuron output(hidden_size, false);
+
+    std::printf("%-8s %-10s %14s %14s\n", "batch", "mode", "allocs/step", "us/step");
+    for (size_t batch : {1, 16, 64}) {
+        // Inputs are long-lived leaves that each step refills, so a replay reads the new batch
+        std::vector<std::vector<Value>> inputs(batch);
+        std::vector<Value> targets;
+        for (size_t s = 0; s < batch; ++s) {
+            for (size_t i = 0; i < input_size; ++i) inputs[s].emplace_back(0.0);
+            targets.emplace_back(0.0);
+        }
+        size_t step_index = 0;
+        auto load_batch = [&] {
+            ++step_index;
+            for (size_t s = 0; s < batch; ++s) {
+                for (size_t i = 0; i < input_size; ++i) {
+                    inputs[s][i].set_data(0.01 * static_cast<double>((step_index + s * 7 + i * 3) % 50) - 0.25);
+                }
+                targets[s].set_data(0.1 * static_cast<double>(s % 5));
+            }
+        };
+        auto build = [&] {
+            Value loss(0.0, false);  // A constant, so verification can match it by value
+            for (size_t s = 0; s < batch; ++s) {
+                std::vector<Value> h;
+                h.reserve(hidden_size);
+                for (Neuron& neuron : hidden) h.push_back(neuron(inputs[s]));
+                loss = loss + (output(h) - targets[s]).pow(2.0);
+            }
+            return loss;
+        };
+
+        auto report = [&](const char* mode, auto&& step) {
+            step();
+            size_t before = allocation_count();
+            double ns = time_per_call_ns(step, steps);
+            double allocs = static_cast<double>(allocation_count() - before) / static_cast<double>(steps);
+            std::printf("%-8zu %-10s %14.1f %14.1f\n", batch, mode, allocs, ns / 1000.0);
+        };
+        report("dynamic", [&] {
+            load_batch();
+            build().backward();
+        });
+        CapturedStep captured(build, 0);  // Pure replay, never verified
+        report("replay", [&] {
+            load_batch();
+            captured();
+        });
+        CapturedStep checked(build);  // The default: every step rebuilt and verified before the replay
+        report("replay/1", [&] {
+            load_batch();
+            checked();
+        });
+        CapturedStep verified(build, 10);
+        report("replay/10", [&] {
+            load_batch();
+            verified();
+        });
+    }
+    return 0;
+}
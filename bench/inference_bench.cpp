@@ -0,0 +1,52 @@
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+#include "arena.hpp"
+#include "bench.hpp"
+#include "neuron.hpp"
+#include "value.hpp"
+
+// Latency and heap allocations of one neuron prediction: recording the graph, under NoGradGuard, under
+// NoGradGuard with an arena, and the same dot product on plain doubles
+int main() {
+    std::printf("%-8s %-14s %14s %14s\n", "inputs", "mode", "allocs/pred", "ns/pred");
+    for (size_t input_size : {10, 100, 1000}) {
+        Neuron neuron(input_size);
+        std::vector<Value> inputs;
+        std::vector<double> weights;
+        std::vector<double> plain_inputs;
+        for (size_t i = 0; i < input_size; ++i) {
+            inputs.emplace_back(0.001 * static_cast<double>(i));
+            plain_inputs.push_back(0.001 * static_cast<double>(i));
+            weights.push_back(neuron.parameters()[i].data());
+        }
+        const size_t predictions = 200000 / input_size + 10;
+        volatile double sink = 0.0;  // Keeps the predictions from being optimised away
+
+        auto report = [&](const char* mode, auto&& predict) {
+            predict();  // warm up thread-local buffers and arena blocks
+            size_t before = allocation_count();
+            double ns = time_per_call_ns(predict, predictions);
+            double allocs = static_cast<double>(allocation_count() - before) / static_cast<double>(predictions);
+            std::printf("%-8zu %-14s %14.1f %14.0f\n", input_size, mode, allocs, ns);
+        };
+
+        report("graph", [&] { sink = sink + neuron(inputs).data(); });
+        report("no-grad", [&] {
+            NoGradGuard guard;
+            sink = sink + neuron(inputs).data();
+        });
+        GraphArena arena;
+        report("no-grad+arena", [&] {
+            NoLeakScope scope(arena);
+            NoGradGuard guard;
+            sink = sink + neuron(inputs).data();
+        });
+        report("double", [&] {
+            double activation = std::inner_product(weights.begin(), weights.end(), plain_inputs.begin(), 0.0);
+            sink = sink + std::max(activation, 0.0);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "mlp.hpp"
+#include "optimizer.hpp"
+
+// Update throughput of each optimizer on a ~1M parameter MLP, against a per-Value loop over parameters()
+int main() {
+    MLP mlp(1000, {1000});
+    const double params = static_cast<double>(mlp.parameter_view().size());
+    for (size_t i = 0; i < mlp.grad_buffer().size(); ++i) {
+        mlp.grad_buffer()[i] = 1e-3 * static_cast<double>(i % 7);
+    }
+
+    SGD sgd(mlp, 1e-3);
+    SGD momentum(mlp, 1e-3, 0.9);
+    Adam adam(mlp);
+    AdamW adamw(mlp);
+    const size_t steps = 50;
+
+    std::printf("%-16s %14s %14s\n", "optimizer", "ms/step", "ms/Mparam");
+    auto report = [&](const char* name, double ns) {
+        std::printf("%-16s %14.3f %14.3f\n", name, ns * 1e-6, ns * 1e-6 / (params * 1e-6));
+    };
+
+    report("per-Value loop", time_per_call_ns(
+                                 [&] {
+                                     for (auto& p : mlp.parameters()) {
+                                         p.set_data(p.data() - 1e-3 * p.grad());
+                                     }
+                                 },
+                                 steps));
+    report("SGD", time_per_call_ns([&] { sgd.step(); }, steps));
+    report("SGD momentum", time_per_call_ns([&] { momentum.step(); }, steps));
+    report("Adam", time_per_call_ns([&] { adam.step(); }, steps));
+    report("AdamW", time_per_call_ns([&] { adamw.step(); }, steps));
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "neuron.hpp"
+#include "thread_pool.hpp"
+#include "value.hpp"
+
+// Backward through a layer of fused neurons sharing one input vector: serial vs work-stealing parallel
+int main() {
+    const size_t inputs_per_neuron = 4096;
+    const size_t neurons = 64;
+
+    std::vector<Value> inputs;
+    for (size_t i = 0; i < inputs_per_neuron; ++i) {
+        inputs.emplace_back(0.001 * static_cast<double>(i % 100));
+    }
+    std::vector<Neuron> layer;
+    for (size_t i = 0; i < neurons; ++i) {
+        layer.emplace_back(inputs_per_neuron);
+    }
+    std::vector<Value> outputs;
+    for (auto& neuron : layer) {
+        outputs.push_back(neuron(inputs));
+    }
+    Value loss = Value::linear(std::vector<Value>(neurons + 1, Value(1.0)), outputs);
+
+    const size_t iterations = 20;
+    std::printf("%-10s %14s %10s\n", "threads", "ms/backward", "speedup");
+    double serial = time_per_call_ns([&] { loss.backward(true); }, iterations);
+    std::printf("%-10s %14.3f %10.2f\n", "serial", serial * 1e-6, 1.0);
+
+    const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads);
+        double ns = time_per_call_ns([&] { loss.backward(pool, true); }, iterations);
+        std::printf("%-10zu %14.3f %10.2f\n", threads, ns * 1e-6, serial / ns);
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "neuron.hpp"
+#include "value.hpp"
+
+// Backward of an input-heavy model: every input is standardised with Value ops before a layer of neurons.
+// With trainable inputs the whole preprocessing subgraph is backpropagated; with requires_grad off it is skipped.
+int main() {
+    constexpr size_t hidden_size = 8;
+    constexpr size_t steps = 200;
+    std::printf("%-8s %-16s %14s\n", "inputs", "inputs require", "backward us");
+    for (size_t input_size : {64, 256, 1024}) {
+        std::vector<Neuron> layer;
+        for (size_t i = 0; i < hidden_size; ++i) layer.emplace_back(input_size);
+
+        for (bool requires_grad : {true, false}) {
+            std::vector<Value> raw;
+            for (size_t i = 0; i < input_size; ++i) raw.emplace_back(0.01 * static_cast<double>(i % 97), requires_grad);
+            Value mean(0.0, requires_grad);
+            for (const Value& x : raw) mean = mean + x;
+            mean = mean / Value(static_cast<double>(input_size), requires_grad);
+            Value variance(0.0, requires_grad);
+            for (const Value& x : raw) variance = variance + (x - mean).pow(2.0);
+            Value scale = (variance / Value(static_cast<double>(input_size), requires_grad)).pow(-0.5);
+            std::vector<Value> standardised;
+            for (const Value& x : raw) standardised.push_back((x - mean) * scale);
+
+            Value loss(0.0);
+            for (Neuron& neuron : layer) loss = loss + neuron(standardised).pow(2.0);
+
+            double ns = time_per_call_ns([&] { loss.backward(); }, steps);
+            std::printf("%-8zu %-16s %14.1f\n", input_size, requires_grad ? "yes" : "no", ns / 1000.0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "checkpoint.hpp"
+#include "graph_file.hpp"
+#include "mlp.hpp"
+#include "neuron.hpp"
+#include "simd.hpp"
+#include "value.hpp"
+
+namespace {
+
+// One entry of the suite. `setup` builds the state of the benchmark and returns the operation to time;
+// `nodes` is the number of graph nodes one operation creates or backpropagates through.
+struct Benchmark {
+    std::string name;
+    size_t nodes;
+    std::function<std::function<void()>()> setup;
+};
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    double ns_per_op;
+    double nodes_per_sec;
+    double allocs_per_op;
+    long peak_rss_kb;
+};
+
+enum class Format { JSON, CSV, Table };
+
+// High-water mark of the resident set of the whole process so far, in KiB
+long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+volatile double sink = 0.0;  // Keeps results from being optimised away
+
+// A chain x -> (x * w + c) repeated `depth` times: backward walks a long path
+Benchmark deep_backward(size_t depth, bool reuse_topology) {
+    const std::string name = std::string(reuse_topology ? "backward/deep_reuse/" : "backward/deep/") +
+                             std::to_string(depth);
+    return {name, 2 * depth, [depth, reuse_topology] {
+                auto w = std::make_shared<Value>(0.999);
+                auto c = std::make_shared<Value>(0.001);
+                auto root = std::make_shared<Value>(1.0);
+                for (size_t i = 0; i < depth; ++i) *root = *root * *w + *c;
+                return std::function<void()>([w, c, root, reuse_topology] { root->backward(reuse_topology); });
+            }};
+}
+
+// Products of `width` input pairs summed by a balanced tree: backward fans out over many short paths
+Benchmark wide_backward(size_t width) {
+    return {"backward/wide/" + std::to_string(width), 2 * width - 1, [width] {
+                auto inputs = std::make_shared<std::vector<Value>>();
+                std::vector<Value> level;
+                for (size_t i = 0; i < width; ++i) {
+                    inputs->emplace_back(0.001 * static_cast<double>(i));
+                    inputs->emplace_back(1.0 - 0.001 * static_cast<double>(i));
+                    level.push_back((*inputs)[2 * i] * (*inputs)[2 * i + 1]);
+                }
+                while (level.size() > 1) {
+                    std::vector<Value> next;
+                    for (size_t i = 0; i + 1 < level.size(); i += 2) next.push_back(level[i] + level[i + 1]);
+                    if (level.size() % 2 != 0) next.push_back(level.back());
+                    level = std::move(next);
+                }
+                auto root = std::make_shared<Value>(level.front());
+                return std::function<void()>([inputs, root] { root->backward(); });
+            }};
+}
+
+// A binary op on two leaves; one node per operation
+template <typename Op>
+Benchmark binary_op(const char* name, Op op) {
+    return {std::string("value/") + name, 1, [op] {
+                auto a = std::make_shared<Value>(1.5);
+                auto b = std::make_shared<Value>(0.75);
+                return std::function<void()>([a, b, op] { sink = sink + op(*a, *b).data(); });
+            }};
+}
+
+Benchmark neuron_forward(size_t input_size, bool backward) {
+    const std::string name = std::string(backward ? "neuron/forward_backward/" : "neuron/forward/") +
+                             std::to_string(input_size);
+    return {name, 1, [input_size, backward] {
+                auto neuron = std::make_shared<Neuron>(input_size);
+                auto inputs = std::make_shared<std::vector<Value>>();
+                for (size_t i = 0; i < input_size; ++i) inputs->emplace_back(0.001 * static_cast<double>(i));
+                return std::function<void()>([neuron, inputs, backward] {
+                    Value out = (*neuron)(*inputs);
+                    if (backward) out.backward();
+                    sink = sink + out.data();
+                });
+            }};
+}
+
+// Saving the deep chain above to a graph file, and loading it back with or without replaying its backward pass
+Benchmark graph_file(const char* mode, size_t depth) {
+    const std::string operation = mode;
+    return {"graph_file/" + operation + "/" + std::to_string(depth), 2 * depth + 3, [operation, depth] {
+                Value w(0.999);
+                Value c(0.001);
+                auto root = std::make_shared<Value>(1.0);
+                for (size_t i = 0; i < depth; ++i) *root = *root * w + c;
+                const std::string path = (std::filesystem::temp_directory_path() / "cppgrad_bench_graph.bin").string();
+                GraphFile::save(*root, path);
+                if (operation == "save") {
+                    return std::function<void()>([root, path] { GraphFile::save(*root, path); });
+                }
+                auto file = std::make_shared<GraphFile>(path);
+                const bool backward = operation == "load_backward";
+                return std::function<void()>([file, backward] {
+                    Value loaded = file->load();
+                    if (backward) loaded.backward();
+                    sink = sink + loaded.grad();
+                });
+            }};
+}
+
+// Saving and loading a checkpoint of an MLP with about a million parameters; `nodes` counts parameters
+Benchmark checkpoint(const char* mode) {
+    const std::string operation = mode;
+    constexpr size_t kParameters = 512 * 1024 + 1024 + 1024 * 512 + 512;
+    return {"checkpoint/" + operation, kParameters, [operation] {
+                auto mlp = std::make_shared<MLP>(512, std::vector<size_t>{1024, 512});
+                const std::string path = (std::filesystem::temp_directory_path() / "cppgrad_bench.ckpt").string();
+                Checkpoint::save(*mlp, path);
+                if (operation == "save") {
+                    return std::function<void()>([mlp, path] { Checkpoint::save(*mlp, path); });
+                }
+                const bool verify = operation == "load";
+                return std::function<void()>([mlp, path, verify] {
+                    Checkpoint::load(*mlp, path, verify);
+                    sink = sink + mlp->data_buffer()[0];
+                });
+            }};
+}
+
+std::vector<Benchmark> suite() {
+    std::vector<Benchmark> benchmarks;
+    benchmarks.push_back({"value/construct", 1, [] {
+                              return std::function<void()>([] { sink = sink + Value(1.0).data(); });
+                          }});
+    benchmarks.push_back(binary_op("add", [](const Value& a, const Value& b) { return a + b; }));
+    benchmarks.push_back(binary_op("sub", [](const Value& a, const Value& b) { return a - b; }));
+    benchmarks.push_back(binary_op("mul", [](const Value& a, const Value& b) { return a * b; }));
+    benchmarks.push_back(binary_op("div", [](const Value& a, const Value& b) { return a / b; }));
+    benchmarks.push_back(binary_op("pow", [](const Value& a, const Value&) { return a.pow(3.0); }));
+    benchmarks.push_back(binary_op("relu", [](const Value& a, const Value&) { return a.relu(); }));
+    for (size_t depth : {100, 10000}) {
+        benchmarks.push_back(deep_backward(depth, false));
+        benchmarks.push_back(deep_backward(depth, true));
+    }
+    for (size_t width : {100, 10000}) benchmarks.push_back(wide_backward(width));
+    for (size_t input_size : {10, 100, 1000}) {
+        benchmarks.push_back(neuron_forward(input_size, false));
+        benchmarks.push_back(neuron_forward(input_size, true));
+    }
+    for (const char* mode : {"save", "load", "load_backward"}) benchmarks.push_back(graph_file(mode, 10000));
+    for (const char* mode : {"save", "load", "load_unverified"}) benchmarks.push_back(checkpoint(mode));
+    return benchmarks;
+}
+
+// Doubles the iteration count until one timed run lasts at least `min_time_s`
+Result run(const Benchmark& benchmark, double min_time_s) {
+    std::function<void()> op = benchmark.setup();
+    op();  // Warm up caches, thread-local buffers and cached topologies
+    size_t iterations = 1;
+    while (true) {
+        const size_t allocations_before = allocation_count();
+        const double ns = time_per_call_ns(op, iterations);
+        const size_t allocations = allocation_count() - allocations_before;
+        if (ns * static_cast<double>(iterations) >= min_time_s * 1e9 || iterations >= (size_t(1) << 30)) {
+            return {benchmark.name,
+                    iterations,
+                    ns,
+                    static_cast<double>(benchmark.nodes) * 1e9 / ns,
+                    static_cast<double>(allocations) / static_cast<double>(iterations),
+                    peak_rss_kb()};
+        }
+        iterations *= 2;
+    }
+}
+
+void print_header(Format format) {
+    if (format == Format::JSON) {
+        std::printf("{\n  \"context\": {\"simd\": \"%s\", \"compiler\": \"%s\"},\n",
+                    simd_level_name(supported_simd_level()), __VERSION__);
+        std::printf("  \"benchmarks\": [");
+    } else if (format == Format::CSV) {
+        std::printf("name,iterations,ns_per_op,nodes_per_sec,allocs_per_op,peak_rss_kb\n");
+    } else {
+        std::printf("%-32s %12s %14s %16s %14s %14s\n", "name", "iterations", "ns/op", "nodes/s", "allocs/op",
+                    "peak_rss_kb");
+    }
+}
+
+void print_result(Format format, const Result& r, bool first) {
+    if (format == Format::JSON) {
+        std::printf("%s\n    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.3f, \"nodes_per_sec\": %.1f, "
+                    "\"allocs_per_op\": %.3f, \"peak_rss_kb\": %ld}",
+                    first ? "" : ",", r.name.c_str(), r.iterations, r.ns_per_op, r.nodes_per_sec, r.allocs_per_op,
+                    r.peak_rss_kb);
+    } else if (format == Format::CSV) {
+        std::printf("%s,%zu,%.3f,%.1f,%.3f,%ld\n", r.name.c_str(), r.iterations, r.ns_per_op, r.nodes_per_sec,
+                    r.allocs_per_op, r.peak_rss_kb);
+    } else {
+        std::printf("%-32s %12zu %14.1f %16.0f %14.2f %14ld\n", r.name.c_str(), r.iterations, r.ns_per_op,
+                    r.nodes_per_sec, r.allocs_per_op, r.peak_rss_kb);
+    }
+    std::fflush(stdout);
+}
+
+void print_footer(Format format) {
+    if (format == Format::JSON) std::printf("\n  ]\n}\n");
+}
+
+int usage(const char* program) {
+    std::fprintf(stderr, "usage: %s [--format=json|csv|table] [--filter=SUBSTRING] [--min-time=SECONDS] [--list]\n",
+                 program);
+    return 2;
+}
+
+}  // namespace
+
+// Reproducible microbenchmarks of the Value engine. Results go to stdout as JSON (default), CSV or a table;
+// peak_rss_kb is the high-water mark of the process after each benchmark, so benchmarks run in a fixed order
+// and a filtered run measures only what it selects.
+int main(int argc, char** argv) {
+    Format format = Format::JSON;
+    std::string filter;
+    double min_time_s = 0.2;
+    bool list = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--format=json") {
+            format = Format::JSON;
+        } else if (arg == "--format=csv") {
+            format = Format::CSV;
+        } else if (arg == "--format=table") {
+            format = Format::Table;
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(std::strlen("--filter="));
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            min_time_s = std::atof(arg.c_str() + std::strlen("--min-time="));
+        } else if (arg == "--list") {
+            list = true;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    bool first = true;
+    if (!list) print_header(format);
+    for (const Benchmark& benchmark : suite()) {
+        if (benchmark.name.find(filter) == std::string::npos) continue;
+        if (list) {
+            std::printf("%s\n", benchmark.name.c_str());
+            continue;
+        }
+        print_result(format, run(benchmark, min_time_s), first);
+        first = false;
+    }
+    if (!list) print_footer(format);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+thread_local NoLeakScope* NoLeakScope::current_ = nullptr;
+
+GraphArena::GraphArena(size_t block_size) : block_size_(block_size) {}
+
+void* GraphArena::allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        if (block_index_ < blocks_.size()) {
+            Block& block = blocks_[block_index_];
+            auto base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+            size_t aligned = ((base + offset_ + alignment - 1) & ~(alignment - 1)) - base;
+            if (aligned + bytes <= block.size) {
+                offset_ = aligned + bytes;
+                live_.fetch_add(1, std::memory_order_relaxed);
+                return block.memory.get() + aligned;
+            }
+            if (block_index_ + 1 < blocks_.size()) {
+                ++block_index_;
+                offset_ = 0;
+                continue;
+            }
+        }
+
+        size_t size = std::max(block_size_, bytes + alignment);
+        blocks_.push_back({std::make_unique<std::byte[]>(size), size});
+        block_index_ = blocks_.size() - 1;
+        offset_ = 0;
+    }
+}
+
+bool GraphArena::reset() noexcept {
+    // Acquire pairs with the release in deallocate(), so no other thread still touches the memory reused
+    if (live_.load(std::memory_order_acquire) != 0) return false;
+    block_index_ = 0;
+    offset_ = 0;
+    return true;
+}
+
+size_t GraphArena::bytes_used() const noexcept {
+    size_t used = offset_;
+    for (size_t i = 0; i < block_index_ && i < blocks_.size(); ++i) {
+        used += blocks_[i].size;
+    }
+    return used;
+}
+
+size_t GraphArena::bytes_reserved() const noexcept {
+    size_t reserved = 0;
+    for (const auto& block : blocks_) {
+        reserved += block.size;
+    }
+    return reserved;
+}
+
+NoLeakScope::NoLeakScope(GraphArena& arena) : arena_(arena), previous_(current_) { current_ = this; }
+
+NoLeakScope::~NoLeakScope() {
+    current_ = previous_;
+    arena_.reset();
+}
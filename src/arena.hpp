@@ -0,0 +1,106 @@
+#ifndef CPPGRAD_ARENA_HPP
+#define CPPGRAD_ARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Bump allocator for the Value nodes of one forward/backward pass. Nodes are never freed
+// individually; reset() rewinds to the first block in O(1) and keeps the blocks for the next step.
+// The arena must outlive every node allocated from it. Allocating and resetting belong to one thread at a
+// time, but nodes may be released on any thread (e.g. a Value handed to a worker).
+class GraphArena {
+   private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    size_t block_size_;
+    size_t block_index_ = 0;
+    size_t offset_ = 0;
+    std::atomic<size_t> live_{0};  // Released nodes may decrement it from other threads
+
+   public:
+    explicit GraphArena(size_t block_size = 64 * 1024);
+
+    GraphArena(const GraphArena&) = delete;
+    GraphArena& operator=(const GraphArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment);
+    void deallocate(void*, size_t) noexcept { live_.fetch_sub(1, std::memory_order_release); }
+
+    // Rewinds the arena, returns false (and keeps the memory) while allocations are still alive
+    bool reset() noexcept;
+
+    size_t live_allocations() const noexcept { return live_.load(std::memory_order_acquire); }
+    size_t bytes_used() const noexcept;
+    size_t bytes_reserved() const noexcept;
+};
+
+template <typename T>
+class ArenaAllocator {
+   private:
+    GraphArena* arena_;
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+   public:
+    using value_type = T;
+
+    explicit ArenaAllocator(GraphArena& arena) noexcept : arena_(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T* p, size_t n) noexcept { arena_->deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ != other.arena_;
+    }
+};
+
+// Routes every Value node created on this thread, with its children array, into the arena until the scope
+// ends, then resets the arena. Values that escape the scope stay valid; the arena is not rewound while any
+// of them is alive.
+class NoLeakScope {
+   private:
+    GraphArena& arena_;
+    NoLeakScope* previous_;
+
+    static thread_local NoLeakScope* current_;
+    friend class PersistentScope;
+
+   public:
+    explicit NoLeakScope(GraphArena& arena);
+    ~NoLeakScope();
+
+    NoLeakScope(const NoLeakScope&) = delete;
+    NoLeakScope& operator=(const NoLeakScope&) = delete;
+
+    GraphArena& arena() noexcept { return arena_; }
+    static NoLeakScope* current() noexcept { return current_; }
+};
+
+// Suspends the active NoLeakScope so that long-lived values (parameters) go to the regular heap
+class PersistentScope {
+   private:
+    NoLeakScope* suspended_;
+
+   public:
+    PersistentScope() noexcept : suspended_(NoLeakScope::current_) { NoLeakScope::current_ = nullptr; }
+    ~PersistentScope() { NoLeakScope::current_ = suspended_; }
+
+    PersistentScope(const PersistentScope&) = delete;
+    PersistentScope& operator=(const PersistentScope&) = delete;
+};
+
+#endif  // CPPGRAD_ARENA_HPP
@@ -0,0 +1,35 @@
+#ifndef CPPGRAD_BFLOAT16_HPP
+#define CPPGRAD_BFLOAT16_HPP
+
+#include <cstdint>
+#include <cstring>
+
+// Software bfloat16: the upper half of an IEEE-754 float (8-bit exponent, 7-bit mantissa). It is a
+// storage format only; values convert to float for arithmetic, rounding to nearest even on the way back.
+class BFloat16 {
+   private:
+    std::uint16_t bits_ = 0;
+
+   public:
+    BFloat16() noexcept = default;
+    BFloat16(float value) noexcept {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if ((bits & 0x7fffffffu) > 0x7f800000u) {
+            bits_ = static_cast<std::uint16_t>((bits >> 16) | 0x0040u);  // Keep NaNs quiet
+        } else {
+            bits_ = static_cast<std::uint16_t>((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+        }
+    }
+
+    operator float() const noexcept {
+        std::uint32_t bits = static_cast<std::uint32_t>(bits_) << 16;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::uint16_t bits() const noexcept { return bits_; }
+};
+
+#endif  // CPPGRAD_BFLOAT16_HPP
@@ -0,0 +1,215 @@
+#include "checkpoint.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "page_storage.hpp"
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'P', 'C', 'K', 'P', 'T', '\0', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr size_t kDataAlignment = 4096;  // A page on common systems, so the data can be mapped
+
+template <typename T>
+constexpr std::uint32_t dtype() {
+    if constexpr (std::is_same_v<T, double>) {
+        return 0;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return 1;
+    } else {
+        static_assert(std::is_same_v<T, BFloat16>, "Unsupported scalar type");
+        return 2;
+    }
+}
+
+std::vector<std::uint64_t> encode_shapes(const std::vector<std::vector<size_t>>& shapes) {
+    std::vector<std::uint64_t> words;
+    for (const auto& shape : shapes) {
+        words.push_back(shape.size());
+        words.insert(words.end(), shape.begin(), shape.end());
+    }
+    return words;
+}
+
+// Makes a rename into the directory of `path` durable
+void sync_directory_of(const std::string& path) {
+    const std::string::size_type slash = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open directory " + directory + ": " + std::strerror(errno));
+    }
+    const bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!synced) {
+        throw std::runtime_error("Failed to flush directory " + directory);
+    }
+}
+
+void write_all(int fd, const void* bytes, size_t size, const std::string& path) {
+    auto p = static_cast<const char*>(bytes);
+    while (size > 0) {
+        const ssize_t written = ::write(fd, p, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write checkpoint " + path + ": " + std::strerror(errno));
+        }
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+// Closes the file when loading finishes or throws
+class FileDescriptor {
+   private:
+    int fd_;
+
+   public:
+    explicit FileDescriptor(int fd) : fd_(fd) {}
+    ~FileDescriptor() {
+        if (fd_ >= 0) ::close(fd_);
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    int get() const noexcept { return fd_; }
+};
+
+}  // namespace
+
+template <typename T>
+std::uint64_t BasicCheckpoint<T>::checksum(const void* data, size_t size) noexcept {
+    // FNV-1a over 64-bit words, then over the remaining bytes
+    constexpr std::uint64_t kPrime = 0x100000001b3ull;
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    auto bytes = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * kPrime;
+    }
+    for (; i < size; ++i) hash = (hash ^ bytes[i]) * kPrime;
+    return hash;
+}
+
+template <typename T>
+void BasicCheckpoint<T>::save(BasicModule<T>& module, const std::string& path) {
+    Span<T> data = module.data_buffer();
+    if (data.empty()) {
+        throw std::runtime_error("Module has no contiguous parameter storage to checkpoint");
+    }
+    const std::vector<std::uint64_t> shapes = encode_shapes(module.parameter_shapes());
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dtype = dtype<T>();
+    header.parameter_count = data.size();
+    header.shape_words = shapes.size();
+    const size_t shapes_end = sizeof(Header) + shapes.size() * sizeof(std::uint64_t);
+    header.data_offset = (shapes_end + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+    header.checksum = checksum(data.data(), data.size() * sizeof(T));
+
+    // A fresh file next to `path`, so the rename stays within one file system and concurrent saves never
+    // write into the same temporary
+    std::string temporary = path + ".XXXXXX";
+    const int fd = ::mkstemp(temporary.data());
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create checkpoint " + temporary + ": " + std::strerror(errno));
+    }
+    try {
+        if (::fchmod(fd, 0644) != 0) {
+            throw std::runtime_error("Cannot set the permissions of checkpoint " + temporary);
+        }
+        static const char padding[kDataAlignment] = {};
+        write_all(fd, &header, sizeof(header), temporary);
+        write_all(fd, shapes.data(), shapes.size() * sizeof(std::uint64_t), temporary);
+        write_all(fd, padding, header.data_offset - shapes_end, temporary);
+        write_all(fd, data.data(), data.size() * sizeof(T), temporary);
+        if (::fsync(fd) != 0) {
+            throw std::runtime_error("Failed to flush checkpoint " + temporary);
+        }
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+    if (::close(fd) != 0 || ::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Failed to write checkpoint " + path);
+    }
+    sync_directory_of(path);
+}
+
+template <typename T>
+bool BasicCheckpoint<T>::load(BasicModule<T>& module, const std::string& path, bool verify) {
+    FileDescriptor file(::open(path.c_str(), O_RDONLY));
+    struct stat info {};
+    if (file.get() < 0 || ::fstat(file.get(), &info) != 0) {
+        throw std::runtime_error("Cannot open checkpoint " + path);
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+
+    Header header;
+    if (size < sizeof(Header)) {
+        throw std::runtime_error("Not a cppgrad checkpoint: " + path);
+    }
+    PageStorage::read(file.get(), 0, &header, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        throw std::runtime_error("Not a cppgrad checkpoint: " + path);
+    }
+    if (header.dtype != dtype<T>()) {
+        throw std::runtime_error("Checkpoint " + path + " was saved for a different scalar type");
+    }
+    if (header.shape_words > size / sizeof(std::uint64_t) || header.data_offset % kDataAlignment != 0 ||
+        header.data_offset < sizeof(Header) + header.shape_words * sizeof(std::uint64_t) ||
+        header.data_offset > size || (size - header.data_offset) / sizeof(T) != header.parameter_count ||
+        (size - header.data_offset) % sizeof(T) != 0) {
+        throw std::runtime_error("Corrupt checkpoint " + path);
+    }
+
+    std::vector<std::uint64_t> shapes(header.shape_words);
+    PageStorage::read(file.get(), sizeof(Header), shapes.data(), shapes.size() * sizeof(std::uint64_t));
+    Span<T> target = module.data_buffer();
+    if (header.parameter_count != target.size() || shapes != encode_shapes(module.parameter_shapes())) {
+        throw std::runtime_error("Checkpoint " + path + " does not match the module's parameter shapes");
+    }
+
+    // Verified through a read-only mapping before anything is written, so a corrupt file leaves the module as
+    // it was; the pages it reads are the ones mapped into the module below
+    const size_t bytes = header.parameter_count * sizeof(T);
+    if (verify) {
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.get(), 0);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Cannot map checkpoint " + path);
+        }
+        const bool intact = checksum(static_cast<char*>(mapping) + header.data_offset, bytes) == header.checksum;
+        ::munmap(mapping, size);
+        if (!intact) {
+            throw std::runtime_error("Checkpoint " + path + " is corrupt: checksum mismatch");
+        }
+    }
+
+    std::shared_ptr<BasicParameterBuffer<T>> buffer = module.parameter_buffer();
+    if (buffer && target.data() >= buffer->data().data() &&
+        target.data() + target.size() <= buffer->data().data() + buffer->size()) {
+        const auto offset = static_cast<size_t>(target.data() - buffer->data().data());
+        return buffer->load_file(file.get(), header.data_offset, offset, target.size());
+    }
+    PageStorage::read(file.get(), header.data_offset, target.data(), bytes);
+    return false;
+}
+
+template class BasicCheckpoint<double>;
+template class BasicCheckpoint<float>;
+template class BasicCheckpoint<BFloat16>;
@@ -0,0 +1,51 @@
+#ifndef CPPGRAD_CHECKPOINT_HPP
+#define CPPGRAD_CHECKPOINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "module.hpp"
+#include "parameter_buffer.hpp"
+
+// Checkpoints of a module's parameter data. The file is a small header (dtype, parameter count, tensor
+// shapes, checksum of the data) followed by data_buffer() exactly as it is laid out in memory, starting on a
+// page boundary. Saving streams the buffer straight to a uniquely named temporary file next to `path`,
+// flushes it, renames it over `path` and flushes the directory, so readers see either the old checkpoint or
+// the complete new one, even after a crash. Loading writes into the module's existing
+// storage, so parameter views, optimizers and replicas stay valid; large parameter buffers have the file's
+// pages mapped into place rather than copied (BasicParameterBuffer::load_file).
+template <typename T>
+class BasicCheckpoint {
+   public:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t dtype;  // 0 double, 1 float, 2 BFloat16
+        std::uint64_t parameter_count;
+        std::uint64_t shape_words;  // Shapes as [rank, dim...] for each tensor, in 64-bit words after the header
+        std::uint64_t data_offset;
+        std::uint64_t checksum;  // Of the data section
+    };
+
+    static void save(BasicModule<T>& module, const std::string& path);
+
+    // Loads the parameters saved by save() for a module of the same architecture, throwing without touching
+    // the module if the file is corrupt or doesn't match. Mapped pages are private: training after loading
+    // never writes to the file. Returns true if any of the data was mapped rather than copied. Skipping
+    // `verify` avoids reading the data for the checksum, at the cost of not detecting a corrupt file.
+    static bool load(BasicModule<T>& module, const std::string& path, bool verify = true);
+
+    // Checksum of the data section
+    static std::uint64_t checksum(const void* data, size_t size) noexcept;
+};
+
+// Defined in checkpoint.cpp for these types only
+extern template class BasicCheckpoint<double>;
+extern template class BasicCheckpoint<float>;
+extern template class BasicCheckpoint<BFloat16>;
+
+using Checkpoint = BasicCheckpoint<double>;
+
+#endif  // CPPGRAD_CHECKPOINT_HPP
@@ -0,0 +1,61 @@
+#include "data_parallel.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Parameters per reduction task; large enough to amortise dispatch, small enough to balance
+constexpr size_t REDUCE_CHUNK = 16 * 1024;
+
+}  // namespace
+
+DataParallelTrainer::DataParallelTrainer(MLP& model, size_t num_workers)
+    : model_(model), pool_(std::max<size_t>(num_workers, 1)) {
+    replicas_.reserve(pool_.size());
+    for (size_t i = 0; i < pool_.size(); ++i) {
+        replicas_.push_back(model_.replica());
+    }
+    shard_losses_.resize(replicas_.size());
+}
+
+double DataParallelTrainer::accumulate_gradients(size_t batch_size, const LossFn& loss_fn) {
+    const size_t shards = replicas_.size();
+    std::fill(shard_losses_.begin(), shard_losses_.end(), 0.0);
+
+    pool_.parallel_for(shards, [&](size_t shard) {
+        size_t begin = batch_size * shard / shards;
+        size_t end = batch_size * (shard + 1) / shards;
+        if (begin == end) return;
+        Tensor loss = loss_fn(replicas_[shard], begin, end);
+        loss.backward();
+        shard_losses_[shard] = loss.item();
+    });
+    reduce_gradients();
+
+    double total = 0.0;
+    for (double loss : shard_losses_) {
+        total += loss;
+    }
+    return total;
+}
+
+void DataParallelTrainer::reduce_gradients() {
+    Span<double> target = model_.grad_buffer();
+    const size_t size = target.size();
+    const size_t chunks = (size + REDUCE_CHUNK - 1) / REDUCE_CHUNK;
+
+    // Each task owns a disjoint slice of the parameters, so no synchronisation is needed; the replica
+    // grads are cleared in the same pass, ready for the next step
+    pool_.parallel_for(chunks, [&](size_t chunk) {
+        const size_t begin = chunk * REDUCE_CHUNK;
+        const size_t end = std::min(size, begin + REDUCE_CHUNK);
+        double* out = target.data();
+        for (auto& replica : replicas_) {
+            double* grad = replica.grad_buffer().data();
+            for (size_t i = begin; i < end; ++i) {
+                out[i] += grad[i];
+                grad[i] = 0.0;
+            }
+        }
+    });
+}
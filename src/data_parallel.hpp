@@ -0,0 +1,41 @@
+#ifndef CPPGRAD_DATA_PARALLEL_HPP
+#define CPPGRAD_DATA_PARALLEL_HPP
+
+#include <functional>
+#include <vector>
+
+#include "mlp.hpp"
+#include "tensor.hpp"
+#include "thread_pool.hpp"
+
+// Data-parallel gradient computation for an MLP. A minibatch of batch_size samples is split into one
+// contiguous shard per worker; each shard runs forward/backward on its own replica of the model (shared
+// data, private grads), and the replica gradients are then summed into the model's grad buffer.
+//
+// The sum for every parameter is taken in shard order, so for a given batch size and worker count the
+// result is bit-identical from run to run regardless of thread scheduling.
+class DataParallelTrainer {
+   public:
+    // Returns the scalar loss of samples [begin, end) evaluated with `model`. Shard losses are summed,
+    // so normalise by the full batch size (not end - begin) to get the gradient of a minibatch mean.
+    using LossFn = std::function<Tensor(const MLP& model, size_t begin, size_t end)>;
+
+   private:
+    MLP& model_;
+    ThreadPool pool_;
+    std::vector<MLP> replicas_;
+    std::vector<double> shard_losses_;
+
+    void reduce_gradients();
+
+   public:
+    explicit DataParallelTrainer(MLP& model, size_t num_workers = std::thread::hardware_concurrency());
+
+    size_t num_workers() const noexcept { return replicas_.size(); }
+
+    // Accumulates the gradient of the summed shard losses into the model's grads (like backward(), it
+    // does not zero them first) and returns the summed loss
+    double accumulate_gradients(size_t batch_size, const LossFn& loss_fn);
+};
+
+#endif  // CPPGRAD_DATA_PARALLEL_HPP
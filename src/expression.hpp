@@ -0,0 +1,359 @@
+#ifndef CPPGRAD_EXPRESSION_HPP
+#define CPPGRAD_EXPRESSION_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "trace.hpp"
+#include "value.hpp"
+
+// Expression templates over BasicValue. Operands wrapped with lazy() combine into an expression whose whole
+// structure lives in its type, e.g.
+//
+//     Value loss = (lazy(prediction) - target).pow(2);
+//
+// Converting the expression to a value records one Op::Fused node whose children are the operands, instead of
+// one node per operator. The node's forward and backward are generated from the expression type: intermediates
+// are rounded to T and gradients are accumulated in the same order as the per-op graph, so data and gradients
+// are bit-identical to spelling the expression with plain Value operators. The one exception is an operand that
+// is itself computed from another operand: the fused node runs before it, so their shared inputs may sum their
+// contributions in a different order. Intermediates are not stored with the node; backward() recomputes them
+// once into a stack array, from which every level of the expression reads its operands.
+
+// Grants the expression types access to the graph nodes of BasicValue
+template <typename T>
+struct FusedAccess {
+    using Value = BasicValue<T>;
+    using Scalar = typename Value::Scalar;
+    using Op = typename Value::Op;
+    using Data = typename Value::Data;
+    using DataPtr = typename Value::DataPtr;
+    using Kernel = typename Value::FusedKernel;
+
+    static const DataPtr& node(const Value& value) noexcept { return value.data_ptr; }
+    static void accumulate(Data& node, Scalar delta) noexcept {
+        if (node.requires_grad) Value::accumulate(node.grad(), delta);
+    }
+
+    // Every intermediate of the per-op graph is stored as T before its consumer reads it
+    static Scalar round(Scalar value) noexcept { return Scalar(T(value)); }
+
+    template <typename E>
+    static Scalar forward(Data* out) {
+        std::array<Scalar, E::value_count> values;
+        return E::evaluate(out->children.get(), out->children.constants(), values.data());
+    }
+
+    template <typename E>
+    static void backward(Data* out) {
+        std::array<Scalar, E::value_count> values;
+        const double* exponents = out->children.constants();
+        E::evaluate(out->children.get(), exponents, values.data());
+        E::backward(out->children.get(), exponents, values.data(), out->grad());
+    }
+
+    template <typename E>
+    static constexpr Kernel kernel = {&FusedAccess::forward<E>, &FusedAccess::backward<E>, E::exponent_count};
+
+    // Children are the leaf operands in order; the exponent of every pow() is stored inline after them
+    template <typename E>
+    static Value materialize(const E& expression) {
+        std::array<Scalar, E::value_count> values;
+        if (NoGradGuard::active()) {
+            std::array<DataPtr, E::leaf_count> leaves;
+            std::array<double, E::exponent_count> exponents;
+            expression.collect(leaves.data(), exponents.data());
+            return Value(E::evaluate(leaves.data(), exponents.data(), values.data()), false);
+        }
+
+        TraceScope trace(TracePhase::Forward, "fused");
+        typename Value::ChildArray children(E::leaf_count, E::exponent_count);
+        expression.collect(children.get(), children.constants());
+        const Scalar result = E::evaluate(children.get(), children.constants(), values.data());
+        DataPtr out = Value::make_data(Op::Fused, result, std::move(children), E::leaf_count);
+        out->fused = &kernel<E>;
+        trace.set_node(out.get());
+        return Value(std::move(out));
+    }
+};
+
+// Common base of the expression types; Derived provides the static interface used by FusedAccess:
+// leaf_count and exponent_count, collect() to gather its operands and exponents, and evaluate()/backward()
+// over those arrays. evaluate() stores the value of every subexpression in post-order, value_count slots in
+// all, the last being the expression's own; backward() reads its operands from those slots.
+struct ExpressionBase {};
+
+template <typename Derived, typename T>
+class Expression : public ExpressionBase {
+   public:
+    using value_type = T;
+    using Scalar = typename BasicValue<T>::Scalar;
+
+    const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+
+    auto pow(double exponent) const;
+    auto relu() const;
+
+    BasicValue<T> value() const { return FusedAccess<T>::materialize(derived()); }
+    operator BasicValue<T>() const { return value(); }
+};
+
+template <typename T>
+class LeafExpression : public Expression<LeafExpression<T>, T> {
+   private:
+    using Access = FusedAccess<T>;
+    using Scalar = typename Access::Scalar;
+    using DataPtr = typename Access::DataPtr;
+
+    BasicValue<T> operand_;
+
+   public:
+    static constexpr bool is_leaf = true;
+    static constexpr size_t leaf_count = 1;
+    static constexpr size_t exponent_count = 0;
+    static constexpr size_t value_count = 1;
+
+    explicit LeafExpression(BasicValue<T> operand) noexcept : operand_(std::move(operand)) {}
+
+    void collect(DataPtr* leaves, double*) const { leaves[0] = Access::node(operand_); }
+
+    static Scalar evaluate(const DataPtr* leaves, const double*, Scalar* values) {
+        return values[0] = leaves[0]->data();
+    }
+    static void backward(const DataPtr* leaves, const double*, const Scalar*, Scalar grad) {
+        Access::accumulate(*leaves[0], grad);
+    }
+};
+
+// The per-op graph hands an intermediate the sum 0 + delta, so a -0 gradient reaches it as +0
+template <typename E, typename Scalar, typename DataPtr>
+inline void backward_operand(const DataPtr* leaves, const double* exponents, const Scalar* values, Scalar grad) {
+    if constexpr (E::is_leaf) {
+        E::backward(leaves, exponents, values, grad);
+    } else {
+        E::backward(leaves, exponents, values, Scalar(0) + grad);
+    }
+}
+
+template <typename T, typename BasicValue<T>::Op op, typename L, typename R>
+class BinaryExpression : public Expression<BinaryExpression<T, op, L, R>, T> {
+   private:
+    using Access = FusedAccess<T>;
+    using Scalar = typename Access::Scalar;
+    using Op = typename Access::Op;
+    using DataPtr = typename Access::DataPtr;
+
+    L lhs_;
+    R rhs_;
+
+    static Scalar apply(Scalar lhs, Scalar rhs) {
+        if constexpr (op == Op::Add) {
+            return Access::round(lhs + rhs);
+        } else if constexpr (op == Op::Sub) {
+            return Access::round(lhs - rhs);
+        } else if constexpr (op == Op::Mul) {
+            return Access::round(lhs * rhs);
+        } else {
+            static_assert(op == Op::Div, "Unsupported binary expression");
+            if (rhs == 0) {
+                throw std::runtime_error("Division by zero");
+            }
+            return Access::round(lhs / rhs);
+        }
+    }
+
+   public:
+    static constexpr bool is_leaf = false;
+    static constexpr size_t leaf_count = L::leaf_count + R::leaf_count;
+    static constexpr size_t exponent_count = L::exponent_count + R::exponent_count;
+    static constexpr size_t value_count = L::value_count + R::value_count + 1;
+
+    BinaryExpression(L lhs, R rhs) noexcept : lhs_(std::move(lhs)), rhs_(std::move(rhs)) {}
+
+    void collect(DataPtr* leaves, double* exponents) const {
+        lhs_.collect(leaves, exponents);
+        rhs_.collect(leaves + L::leaf_count, exponents + L::exponent_count);
+    }
+
+    static Scalar evaluate(const DataPtr* leaves, const double* exponents, Scalar* values) {
+        const Scalar lhs = L::evaluate(leaves, exponents, values);
+        const Scalar rhs = R::evaluate(leaves + L::leaf_count, exponents + L::exponent_count, values + L::value_count);
+        return values[value_count - 1] = apply(lhs, rhs);
+    }
+
+    // Mirrors propagate(): both operand gradients first, leaves accumulated immediately, then the right
+    // subexpression before the left one, as in the reverse topological order of the per-op graph
+    static void backward(const DataPtr* leaves, const double* exponents, const Scalar* values, Scalar grad) {
+        const DataPtr* rhs_leaves = leaves + L::leaf_count;
+        const double* rhs_exponents = exponents + L::exponent_count;
+        const Scalar* rhs_values = values + L::value_count;
+        Scalar lhs_grad;
+        Scalar rhs_grad;
+        if constexpr (op == Op::Add) {
+            lhs_grad = grad;
+            rhs_grad = grad;
+        } else if constexpr (op == Op::Sub) {
+            lhs_grad = grad;
+            rhs_grad = -grad;
+        } else if constexpr (op == Op::Mul) {
+            lhs_grad = rhs_values[R::value_count - 1] * grad;
+            rhs_grad = values[L::value_count - 1] * grad;
+        } else {
+            const Scalar lhs = values[L::value_count - 1];
+            const Scalar denominator = rhs_values[R::value_count - 1];
+            lhs_grad = grad / denominator;
+            rhs_grad = -(grad * lhs / (denominator * denominator));
+        }
+
+        if constexpr (L::is_leaf) {
+            backward_operand<L>(leaves, exponents, values, lhs_grad);
+        }
+        backward_operand<R>(rhs_leaves, rhs_exponents, rhs_values, rhs_grad);
+        if constexpr (!L::is_leaf) {
+            backward_operand<L>(leaves, exponents, values, lhs_grad);
+        }
+    }
+};
+
+template <typename T, typename E>
+class PowExpression : public Expression<PowExpression<T, E>, T> {
+   private:
+    using Access = FusedAccess<T>;
+    using Scalar = typename Access::Scalar;
+    using DataPtr = typename Access::DataPtr;
+
+    E base_;
+    double exponent_;
+
+   public:
+    static constexpr bool is_leaf = false;
+    static constexpr size_t leaf_count = E::leaf_count;
+    static constexpr size_t exponent_count = E::exponent_count + 1;  // Own exponent after those of the base
+    static constexpr size_t value_count = E::value_count + 1;
+
+    PowExpression(E base, double exponent) noexcept : base_(std::move(base)), exponent_(exponent) {}
+
+    void collect(DataPtr* leaves, double* exponents) const {
+        base_.collect(leaves, exponents);
+        exponents[E::exponent_count] = exponent_;
+    }
+
+    static Scalar evaluate(const DataPtr* leaves, const double* exponents, Scalar* values) {
+        const Scalar base = E::evaluate(leaves, exponents, values);
+        const double exponent = exponents[E::exponent_count];
+        if (base < 0 && std::floor(exponent) != exponent) {
+            throw std::runtime_error("Imaginary result not allowed");
+        }
+        if (base == 0 && exponent <= 0) {
+            throw std::runtime_error("Invalid exponentiation");
+        }
+        return values[value_count - 1] = Access::round(static_cast<Scalar>(std::pow(base, exponent)));
+    }
+
+    static void backward(const DataPtr* leaves, const double* exponents, const Scalar* values, Scalar grad) {
+        const double exponent = exponents[E::exponent_count];
+        const Scalar base = values[E::value_count - 1];
+        backward_operand<E>(leaves, exponents, values,
+                            static_cast<Scalar>(exponent * std::pow(base, exponent - 1) * grad));
+    }
+};
+
+template <typename T, typename E>
+class ReLUExpression : public Expression<ReLUExpression<T, E>, T> {
+   private:
+    using Access = FusedAccess<T>;
+    using Scalar = typename Access::Scalar;
+    using DataPtr = typename Access::DataPtr;
+
+    E input_;
+
+   public:
+    static constexpr bool is_leaf = false;
+    static constexpr size_t leaf_count = E::leaf_count;
+    static constexpr size_t exponent_count = E::exponent_count;
+    static constexpr size_t value_count = E::value_count + 1;
+
+    explicit ReLUExpression(E input) noexcept : input_(std::move(input)) {}
+
+    void collect(DataPtr* leaves, double* exponents) const { input_.collect(leaves, exponents); }
+
+    static Scalar evaluate(const DataPtr* leaves, const double* exponents, Scalar* values) {
+        return values[value_count - 1] = Access::round(std::max<Scalar>(E::evaluate(leaves, exponents, values), 0));
+    }
+
+    static void backward(const DataPtr* leaves, const double* exponents, const Scalar* values, Scalar grad) {
+        const Scalar input = values[E::value_count - 1];
+        backward_operand<E>(leaves, exponents, values, (input > 0) ? grad : Scalar(0));
+    }
+};
+
+template <typename Derived, typename T>
+auto Expression<Derived, T>::pow(double exponent) const {
+    return PowExpression<T, Derived>(derived(), exponent);
+}
+
+template <typename Derived, typename T>
+auto Expression<Derived, T>::relu() const {
+    return ReLUExpression<T, Derived>(derived());
+}
+
+// Starts an expression; everything combined with the result is fused until it is converted to a value
+template <typename T>
+LeafExpression<T> lazy(const BasicValue<T>& value) {
+    return LeafExpression<T>(value);
+}
+
+template <typename X>
+inline constexpr bool is_expression_v = std::is_base_of_v<ExpressionBase, X>;
+
+template <typename Derived, typename T>
+const Derived& as_expression(const Expression<Derived, T>& expression) noexcept {
+    return expression.derived();
+}
+
+template <typename T>
+LeafExpression<T> as_expression(const BasicValue<T>& value) {
+    return LeafExpression<T>(value);
+}
+
+template <typename X>
+using expression_type_t = typename std::decay_t<decltype(as_expression(std::declval<const X&>()))>::value_type;
+
+template <auto op, typename A, typename B>
+auto make_binary_expression(const A& lhs, const B& rhs) {
+    using L = std::decay_t<decltype(as_expression(lhs))>;
+    using R = std::decay_t<decltype(as_expression(rhs))>;
+    using T = typename L::value_type;
+    static_assert(std::is_same_v<T, typename R::value_type>, "Expression operands must share a storage type");
+    return BinaryExpression<T, op, L, R>(as_expression(lhs), as_expression(rhs));
+}
+
+// Operators taking an expression on either side and an expression or a value on the other
+template <typename A, typename B, typename = std::enable_if_t<is_expression_v<A> || is_expression_v<B>>>
+auto operator+(const A& lhs, const B& rhs) {
+    return make_binary_expression<BasicValue<expression_type_t<A>>::Op::Add>(lhs, rhs);
+}
+
+template <typename A, typename B, typename = std::enable_if_t<is_expression_v<A> || is_expression_v<B>>>
+auto operator-(const A& lhs, const B& rhs) {
+    return make_binary_expression<BasicValue<expression_type_t<A>>::Op::Sub>(lhs, rhs);
+}
+
+template <typename A, typename B, typename = std::enable_if_t<is_expression_v<A> || is_expression_v<B>>>
+auto operator*(const A& lhs, const B& rhs) {
+    return make_binary_expression<BasicValue<expression_type_t<A>>::Op::Mul>(lhs, rhs);
+}
+
+template <typename A, typename B, typename = std::enable_if_t<is_expression_v<A> || is_expression_v<B>>>
+auto operator/(const A& lhs, const B& rhs) {
+    return make_binary_expression<BasicValue<expression_type_t<A>>::Op::Div>(lhs, rhs);
+}
+
+#endif  // CPPGRAD_EXPRESSION_HPP
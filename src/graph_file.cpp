@@ -0,0 +1,293 @@
+#include "graph_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'P', 'G', 'R', 'A', 'P', 'H', '\0'};
+constexpr std::uint32_t kVersion = 1;
+
+template <typename T>
+constexpr std::uint32_t scalar_type() {
+    if constexpr (std::is_same_v<T, double>) {
+        return 0;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return 1;
+    } else {
+        static_assert(std::is_same_v<T, BFloat16>, "Unsupported scalar type");
+        return 2;
+    }
+}
+
+constexpr size_t align8(size_t offset) { return (offset + 7) & ~size_t(7); }
+
+// Offsets of the sections after the header
+struct Layout {
+    size_t nodes;
+    size_t data;
+    size_t grads;
+    size_t edges;
+    size_t end;
+};
+
+template <typename Header, typename Record, typename T, typename Scalar>
+Layout layout(size_t node_count, size_t edge_count) {
+    Layout l;
+    l.nodes = align8(sizeof(Header));
+    l.data = align8(l.nodes + node_count * sizeof(Record));
+    l.grads = align8(l.data + node_count * sizeof(T));
+    l.edges = align8(l.grads + node_count * sizeof(Scalar));
+    l.end = l.edges + edge_count * sizeof(std::uint32_t);
+    return l;
+}
+
+void write_at(std::ostream& out, size_t& written, size_t offset, const void* bytes, size_t size) {
+    static const char zeros[8] = {};
+    out.write(zeros, static_cast<std::streamsize>(offset - written));
+    out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+    written = offset + size;
+}
+
+}  // namespace
+
+template <typename T>
+void BasicGraphFile<T>::save(const BasicValue<T>& root, std::ostream& out) {
+    using Data = typename BasicValue<T>::Data;
+    std::vector<Data*> order;
+    BasicValue<T>::build_topo(root.data_ptr.get(), order, false);
+    if (order.size() > UINT32_MAX) {
+        throw std::runtime_error("Graph has too many nodes to save");
+    }
+
+    std::unordered_map<const Data*, std::uint32_t> index;
+    index.reserve(order.size());
+    std::vector<NodeRecord> records(order.size());
+    std::vector<T> data(order.size());
+    std::vector<Scalar> grads(order.size());
+    std::vector<std::uint32_t> edges;
+    for (size_t i = 0; i < order.size(); ++i) {
+        Data& node = *order[i];
+        if (node.op == Op::Fused) {
+            throw std::runtime_error("Graphs with fused expressions cannot be saved");
+        }
+        index.emplace(&node, static_cast<std::uint32_t>(i));
+        NodeRecord& record = records[i];
+        std::memset(&record, 0, sizeof(record));
+        record.exponent = node.op == Op::Pow ? node.exponent : 0.0;
+        record.first_edge = edges.size();
+        record.num_children = node.num_children;
+        record.op = node.op;
+        record.requires_grad = node.requires_grad ? 1 : 0;
+        for (const auto& child : node.child_span()) edges.push_back(index.at(child.get()));
+        data[i] = node.data();
+        grads[i] = node.grad();
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.scalar_type = scalar_type<T>();
+    header.node_count = order.size();
+    header.edge_count = edges.size();
+    const Layout l = layout<Header, NodeRecord, T, Scalar>(order.size(), edges.size());
+    size_t written = 0;
+    write_at(out, written, 0, &header, sizeof(header));
+    write_at(out, written, l.nodes, records.data(), records.size() * sizeof(NodeRecord));
+    write_at(out, written, l.data, data.data(), data.size() * sizeof(T));
+    write_at(out, written, l.grads, grads.data(), grads.size() * sizeof(Scalar));
+    write_at(out, written, l.edges, edges.data(), edges.size() * sizeof(std::uint32_t));
+    if (!out) {
+        throw std::runtime_error("Failed to write graph");
+    }
+}
+
+template <typename T>
+void BasicGraphFile<T>::save(const BasicValue<T>& root, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open graph file " + path);
+    }
+    save(root, out);
+}
+
+template <typename T>
+std::string BasicGraphFile<T>::to_dot(const BasicValue<T>& root, size_t max_nodes) {
+    using Data = typename BasicValue<T>::Data;
+    std::vector<Data*> order;
+    BasicValue<T>::build_topo(root.data_ptr.get(), order, false);
+    if (order.size() > max_nodes) {
+        throw std::runtime_error("Graph has " + std::to_string(order.size()) + " nodes, more than " +
+                                 std::to_string(max_nodes) + " to render");
+    }
+
+    std::unordered_map<const Data*, size_t> index;
+    std::ostringstream dot;
+    dot << "digraph cppgrad {\n    rankdir=TB;\n    node [shape=record];\n";
+    for (size_t i = 0; i < order.size(); ++i) {
+        Data& node = *order[i];
+        index.emplace(&node, i);
+        std::string op(BasicValue<T>::op_name(node.op));
+        if (node.op == Op::Leaf) op = node.requires_grad ? "leaf" : "const";
+        if (node.op == Op::Pow) op += " " + std::to_string(node.exponent);
+        dot << "    n" << i << " [label=\"{" << op << " | data " << Scalar(node.data()) << " | grad " << node.grad()
+            << "}\"];\n";
+        for (const auto& child : node.child_span()) {
+            dot << "    n" << index.at(child.get()) << " -> n" << i << ";\n";
+        }
+    }
+    dot << "}\n";
+    return dot.str();
+}
+
+template <typename T>
+BasicGraphFile<T>::BasicGraphFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open graph file " + path);
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error("Not a cppgrad graph file: " + path);
+    }
+    mapping_size_ = static_cast<size_t>(info.st_size);
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw std::runtime_error("Cannot map graph file " + path);
+    }
+    header_ = static_cast<const Header*>(mapping_);
+    try {
+        validate(path);
+    } catch (...) {
+        ::munmap(mapping_, mapping_size_);
+        throw;
+    }
+}
+
+template <typename T>
+void BasicGraphFile<T>::validate(const std::string& path) {
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 || header_->version != kVersion) {
+        throw std::runtime_error("Not a cppgrad graph file: " + path);
+    }
+    if (header_->scalar_type != scalar_type<T>()) {
+        throw std::runtime_error("Graph file " + path + " was saved for a different scalar type");
+    }
+    if (header_->node_count == 0 || header_->node_count > UINT32_MAX || header_->edge_count > mapping_size_) {
+        throw std::runtime_error("Corrupt graph file " + path);
+    }
+    const Layout l = layout<Header, NodeRecord, T, Scalar>(header_->node_count, header_->edge_count);
+    if (l.end != mapping_size_) {
+        throw std::runtime_error("Corrupt graph file " + path);
+    }
+    auto base = static_cast<const char*>(mapping_);
+    nodes_ = reinterpret_cast<const NodeRecord*>(base + l.nodes);
+    data_ = reinterpret_cast<const T*>(base + l.data);
+    grads_ = reinterpret_cast<const Scalar*>(base + l.grads);
+    edges_ = reinterpret_cast<const std::uint32_t*>(base + l.edges);
+
+    for (size_t i = 0; i < size(); ++i) {
+        const NodeRecord& record = nodes_[i];
+        bool arity_ok;
+        switch (record.op) {
+            case Op::Leaf:
+                arity_ok = record.num_children == 0;
+                break;
+            case Op::Add:
+            case Op::Sub:
+            case Op::Mul:
+            case Op::Div:
+                arity_ok = record.num_children == 2;
+                break;
+            case Op::Pow:
+            case Op::ReLU:
+                arity_ok = record.num_children == 1;
+                break;
+            case Op::Linear:
+            case Op::LinearReLU:
+                arity_ok = record.num_children % 2 == 1;
+                break;
+            default:
+                arity_ok = false;
+                break;
+        }
+        if (!arity_ok || record.first_edge > header_->edge_count ||
+            record.num_children > header_->edge_count - record.first_edge) {
+            throw std::runtime_error("Corrupt graph file " + path);
+        }
+        for (std::uint32_t child : children(i)) {
+            if (child >= i) throw std::runtime_error("Corrupt graph file " + path);
+        }
+    }
+}
+
+template <typename T>
+BasicGraphFile<T>::~BasicGraphFile() {
+    if (mapping_ != nullptr) ::munmap(mapping_, mapping_size_);
+}
+
+template <typename T>
+BasicGraphFile<T>::BasicGraphFile(BasicGraphFile&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      mapping_size_(other.mapping_size_),
+      header_(other.header_),
+      nodes_(other.nodes_),
+      data_(other.data_),
+      grads_(other.grads_),
+      edges_(other.edges_) {}
+
+template <typename T>
+BasicGraphFile<T>& BasicGraphFile<T>::operator=(BasicGraphFile&& other) noexcept {
+    if (this != &other) {
+        if (mapping_ != nullptr) ::munmap(mapping_, mapping_size_);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = other.mapping_size_;
+        header_ = other.header_;
+        nodes_ = other.nodes_;
+        data_ = other.data_;
+        grads_ = other.grads_;
+        edges_ = other.edges_;
+    }
+    return *this;
+}
+
+template <typename T>
+BasicValue<T> BasicGraphFile<T>::load() const {
+    using DataPtr = typename BasicValue<T>::DataPtr;
+    using ChildArray = typename BasicValue<T>::ChildArray;
+    std::vector<DataPtr> nodes(size());
+    for (size_t i = 0; i < size(); ++i) {
+        const NodeRecord& record = nodes_[i];
+        ChildArray children;
+        if (record.num_children != 0) {
+            children = ChildArray(record.num_children);
+            for (std::uint32_t c = 0; c < record.num_children; ++c) {
+                children[c] = nodes[edges_[record.first_edge + c]];
+            }
+        }
+        DataPtr node = BasicValue<T>::make_data(record.op, data(i), std::move(children), record.num_children);
+        node->data() = data_[i];
+        node->grad() = grads_[i];
+        node->exponent = record.exponent;
+        node->requires_grad = record.requires_grad != 0;
+        nodes[i] = std::move(node);
+    }
+    return BasicValue<T>(std::move(nodes.back()));
+}
+
+template class BasicGraphFile<double>;
+template class BasicGraphFile<float>;
+template class BasicGraphFile<BFloat16>;
@@ -0,0 +1,96 @@
+#ifndef CPPGRAD_GRAPH_FILE_HPP
+#define CPPGRAD_GRAPH_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "span.hpp"
+#include "value.hpp"
+
+// A Value graph saved to disk: every node reachable from a root with its op, data, grad and child edges, so
+// that a captured graph can be inspected or have its backward pass replayed without the model that built it.
+//
+// The file holds, in native byte order and with each section 8-byte aligned: a header, one fixed-size record
+// per node (op, flags, exponent, edge range), the node data as T, the node gradients as Scalar, and the child
+// edges as 32-bit node indices. Nodes are stored children first, the root last, so every edge points to an
+// earlier node. Reading maps the file into memory; accessors read it in place, and load() rebuilds the graph.
+template <typename T>
+class BasicGraphFile {
+   public:
+    using Scalar = typename BasicValue<T>::Scalar;
+    using Op = typename BasicValue<T>::Op;
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t scalar_type;  // 0 double, 1 float, 2 BFloat16
+        std::uint64_t node_count;
+        std::uint64_t edge_count;
+    };
+
+    struct NodeRecord {
+        double exponent;  // Op::Pow only
+        std::uint64_t first_edge;
+        std::uint32_t num_children;
+        Op op;
+        std::uint8_t requires_grad;
+        std::uint8_t reserved[2];
+    };
+
+   private:
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    const Header* header_ = nullptr;
+    const NodeRecord* nodes_ = nullptr;
+    const T* data_ = nullptr;
+    const Scalar* grads_ = nullptr;
+    const std::uint32_t* edges_ = nullptr;
+
+    // Checks the header and that every node is a well-formed op over earlier nodes, and sets the section pointers
+    void validate(const std::string& path);
+
+   public:
+    // Writes the graph below `root`. Graphs with fused nodes (expression.hpp) cannot be saved, as their
+    // kernels only exist in the program that built them.
+    static void save(const BasicValue<T>& root, std::ostream& out);
+    static void save(const BasicValue<T>& root, const std::string& path);
+
+    // Graphviz rendering of a small graph, leaves at the top and edges pointing from children to their
+    // parents; throws if the graph has more than `max_nodes` nodes
+    static std::string to_dot(const BasicValue<T>& root, size_t max_nodes = 1000);
+
+    // Maps and validates a file written by save() for the same T
+    explicit BasicGraphFile(const std::string& path);
+    ~BasicGraphFile();
+    BasicGraphFile(BasicGraphFile&& other) noexcept;
+    BasicGraphFile& operator=(BasicGraphFile&& other) noexcept;
+    BasicGraphFile(const BasicGraphFile&) = delete;
+    BasicGraphFile& operator=(const BasicGraphFile&) = delete;
+
+    size_t size() const noexcept { return header_->node_count; }
+    size_t root() const noexcept { return size() - 1; }
+
+    Op op(size_t node) const noexcept { return nodes_[node].op; }
+    Scalar data(size_t node) const noexcept { return Scalar(data_[node]); }
+    Scalar grad(size_t node) const noexcept { return grads_[node]; }
+    double exponent(size_t node) const noexcept { return nodes_[node].exponent; }
+    bool requires_grad(size_t node) const noexcept { return nodes_[node].requires_grad != 0; }
+    Span<const std::uint32_t> children(size_t node) const noexcept {
+        return Span<const std::uint32_t>(edges_ + nodes_[node].first_edge, nodes_[node].num_children);
+    }
+
+    // Rebuilds the graph as new nodes with the saved data and gradients and returns its root. Leaves that
+    // were parameter views come back as plain leaves.
+    BasicValue<T> load() const;
+};
+
+// Defined in graph_file.cpp for these types only
+extern template class BasicGraphFile<double>;
+extern template class BasicGraphFile<float>;
+extern template class BasicGraphFile<BFloat16>;
+
+using GraphFile = BasicGraphFile<double>;
+
+#endif  // CPPGRAD_GRAPH_FILE_HPP
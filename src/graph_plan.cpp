@@ -0,0 +1,274 @@
+#include "graph_plan.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+
+// Hash of a node key: opcode, payload bits and child addresses
+struct KeyHash {
+    size_t operator()(const std::vector<std::uintptr_t>& key) const noexcept {
+        size_t hash = key.size();
+        for (std::uintptr_t word : key) {
+            hash ^= std::hash<std::uintptr_t>()(word) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+template <typename X>
+std::uintptr_t bits_of(X x) noexcept {
+    std::uintptr_t bits = 0;
+    static_assert(sizeof(X) <= sizeof(bits), "Payload must fit in a key word");
+    std::memcpy(&bits, &x, sizeof(X));
+    return bits;
+}
+
+}  // namespace
+
+template <typename T>
+BasicGraphPlan<T>::BasicGraphPlan(BasicValue<T> root) : root_(std::move(root)) {
+    set_order();
+}
+
+template <typename T>
+void BasicGraphPlan<T>::set_order() {
+    // Replays recompute the whole graph, so unlike backward() the order also covers subgraphs that require
+    // no gradient
+    order_.clear();
+    BasicValue<T>::build_topo(root_.data_ptr.get(), order_, false);
+    interior_.clear();
+    backward_.clear();
+    for (Data* node : order_) {
+        if (node->num_children == 0) continue;
+        interior_.push_back(node);
+        if (node->requires_grad) backward_.push_back(node);
+    }
+}
+
+template <typename T>
+GraphPassReport BasicGraphPlan<T>::optimize(const std::vector<BasicValue<T>>& parameters) {
+    using Op = typename BasicValue<T>::Op;
+    using DataPtr = typename BasicValue<T>::DataPtr;
+    const std::vector<Data*> order = order_;
+    GraphPassReport report;
+    report.nodes_before = order.size();
+
+    // Owning references to every node keep the graph alive while it is rewritten. A leaf is a constant when
+    // nothing but its parents and this table refers to it.
+    std::unordered_map<const Data*, DataPtr> owners;
+    std::unordered_map<const Data*, long> parent_edges;
+    owners.emplace(root_.data_ptr.get(), root_.data_ptr);
+    for (Data* node : order) {
+        for (const DataPtr& child : node->child_span()) {
+            owners.emplace(child.get(), child);
+            ++parent_edges[child.get()];
+        }
+    }
+
+    std::unordered_set<const Data*> constants;
+    std::unordered_map<std::vector<std::uintptr_t>, DataPtr, KeyHash> canonical;
+    std::unordered_map<const Data*, DataPtr> replacement;
+    std::vector<std::uintptr_t> key;
+    for (Data* node : order) {
+        for (DataPtr& child : node->child_span()) {
+            auto it = replacement.find(child.get());
+            if (it != replacement.end()) child = it->second;
+        }
+
+        bool constant;
+        if (node->num_children == 0) {
+            constant = !node->is_view && owners[node].use_count() == parent_edges[node] + 1;
+        } else {
+            const Span<DataPtr> children = node->child_span();
+            constant = std::all_of(children.begin(), children.end(),
+                                   [&](const DataPtr& child) { return constants.count(child.get()) != 0; });
+            if (constant) {
+                // The node's data already holds its value; the folded leaf keeps it and drops the children
+                node->children.reset();
+                node->num_children = 0;
+                node->op = Op::Leaf;
+                node->exponent = 0.0;
+                ++report.folded;
+            }
+        }
+
+        key.clear();
+        key.push_back(static_cast<std::uintptr_t>(node->op));
+        if (constant) {
+            constants.insert(node);
+            key.push_back(bits_of(Scalar(node->data())));
+            key.push_back(bits_of(node->exponent));
+        } else if (node->op == Op::Leaf) {
+            continue;  // Parameters and inputs are distinct even when their values are equal
+        } else if (node->op == Op::Pow) {
+            key.push_back(bits_of(node->exponent));
+        } else if (node->op == Op::Fused) {
+            key.push_back(reinterpret_cast<std::uintptr_t>(node->fused));
+            const double* exponents = node->children.constants();
+            for (std::uint32_t i = 0; i < node->fused->num_constants; ++i) key.push_back(bits_of(exponents[i]));
+        }
+        for (const DataPtr& child : node->child_span()) {
+            key.push_back(reinterpret_cast<std::uintptr_t>(child.get()));
+        }
+        auto [it, inserted] = canonical.try_emplace(key, owners[node]);
+        if (!inserted) {
+            replacement.emplace(node, it->second);
+            ++report.deduplicated;
+        }
+    }
+
+    // Orders cached by backward(true) on the rewritten nodes, and on roots above them outside the plan, may
+    // list nodes that were folded away or merged (and freed with `owners`)
+    for (Data* node : order) {
+        node->topo_order.reset();
+    }
+    BasicValue<T>::graph_rewrites.fetch_add(1, std::memory_order_release);
+    set_order();
+    report.nodes_after = order_.size();
+
+    if (!parameters.empty()) {
+        std::unordered_set<const Data*> reaches;
+        for (const BasicValue<T>& parameter : parameters) {
+            reaches.insert(parameter.data_ptr.get());
+        }
+        backward_.clear();
+        for (Data* node : interior_) {
+            if (!node->requires_grad) continue;
+            const Span<DataPtr> children = node->child_span();
+            if (std::any_of(children.begin(), children.end(),
+                            [&](const DataPtr& child) { return reaches.count(child.get()) != 0; })) {
+                reaches.insert(node);
+                backward_.push_back(node);
+            }
+        }
+    }
+    report.pruned = interior_.size() - backward_.size();
+    return report;
+}
+
+template <typename T>
+typename BasicGraphPlan<T>::Scalar BasicGraphPlan<T>::forward() {
+    for (Data* node : interior_) {
+        BasicValue<T>::recompute(node);
+    }
+    return root_.data();
+}
+
+template <typename T>
+void BasicGraphPlan<T>::backward() {
+    for (Data* node : interior_) {
+        node->grad() = 0;
+    }
+    root_.data_ptr->grad() = 1.0;
+    for (auto it = backward_.rbegin(); it != backward_.rend(); ++it) {
+        BasicValue<T>::propagate(*it);
+    }
+}
+
+template <typename T>
+void BasicGraphPlan<T>::backward(ThreadPool& pool) {
+    for (Data* node : interior_) {
+        node->grad() = 0;
+    }
+    root_.backward(pool, true);
+}
+
+template <typename T>
+bool BasicGraphPlan<T>::matches(const BasicValue<T>& root) const {
+    using Op = typename BasicValue<T>::Op;
+    const std::vector<Data*>& order = order_;
+    std::vector<Data*> other;
+    BasicValue<T>::build_topo(root.data_ptr.get(), other, false);
+    if (other.size() != order.size()) return false;
+
+    // Both orders come from the same deterministic traversal, so equal graphs list their nodes at equal positions
+    auto positions = [](const std::vector<Data*>& nodes) {
+        std::vector<std::pair<const Data*, std::uint32_t>> sorted(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) sorted[i] = {nodes[i], static_cast<std::uint32_t>(i)};
+        std::sort(sorted.begin(), sorted.end());
+        return sorted;
+    };
+    auto position_of = [](const auto& sorted, const Data* node) {
+        return std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(node, std::uint32_t(0)))->second;
+    };
+    const auto position = positions(order);
+    const auto other_position = positions(other);
+    for (size_t i = 0; i < order.size(); ++i) {
+        Data& a = *order[i];
+        Data& b = *other[i];
+        if (a.op != b.op || a.num_children != b.num_children) return false;
+        switch (a.op) {
+            case Op::Leaf:
+                // A replay sends gradients to the captured leaves, so a leaf that receives one must be the
+                // same node; any other leaf is replayed at its captured value
+                if (a.requires_grad || b.requires_grad) {
+                    if (&a != &b) return false;
+                } else if (Scalar(a.data()) != Scalar(b.data())) {
+                    return false;
+                }
+                break;
+            case Op::Pow:
+                if (a.exponent != b.exponent) return false;
+                break;
+            case Op::Fused:
+                if (a.fused != b.fused ||
+                    !std::equal(a.children.constants(), a.children.constants() + a.fused->num_constants,
+                                b.children.constants())) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+        for (std::uint32_t c = 0; c < a.num_children; ++c) {
+            if (position_of(position, a.children[c].get()) != position_of(other_position, b.children[c].get())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename T>
+BasicCapturedStep<T>::BasicCapturedStep(std::function<BasicValue<T>()> build, size_t verify_interval, bool strict)
+    : build_(std::move(build)), verify_interval_(verify_interval), strict_(strict) {}
+
+template <typename T>
+typename BasicCapturedStep<T>::Scalar BasicCapturedStep<T>::run_dynamic(BasicValue<T> root) {
+    plan_ = BasicGraphPlan<T>::capture(root);
+    plan_->backward();
+    return root.data();
+}
+
+template <typename T>
+typename BasicCapturedStep<T>::Scalar BasicCapturedStep<T>::operator()() {
+    ++steps_;
+    if (!plan_) {
+        return run_dynamic(build_());
+    }
+    if (verify_interval_ != 0 && steps_ % verify_interval_ == 0) {
+        BasicValue<T> root = build_();
+        if (!plan_->matches(root)) {
+            if (strict_) {
+                throw std::runtime_error("Captured step no longer matches its graph: control flow in the step changed");
+            }
+            ++recaptures_;
+            return run_dynamic(std::move(root));
+        }
+    }
+    const Scalar loss = plan_->forward();
+    plan_->backward();
+    return loss;
+}
+
+template class BasicGraphPlan<double>;
+template class BasicGraphPlan<float>;
+template class BasicGraphPlan<BFloat16>;
+template class BasicCapturedStep<double>;
+template class BasicCapturedStep<float>;
+template class BasicCapturedStep<BFloat16>;
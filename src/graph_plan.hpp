@@ -0,0 +1,128 @@
+#ifndef CPPGRAD_GRAPH_PLAN_HPP
+#define CPPGRAD_GRAPH_PLAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "value.hpp"
+
+// Node counts of a graph before and after BasicGraphPlan::optimize()
+struct GraphPassReport {
+    size_t nodes_before = 0;
+    size_t nodes_after = 0;
+    size_t folded = 0;        // Interior nodes turned into constants
+    size_t deduplicated = 0;  // Nodes merged into an identical earlier node
+    size_t pruned = 0;        // Interior nodes left out of backward()
+};
+
+// Captured graph of one forward/backward pass that can be re-executed without rebuilding it. The plan keeps
+// the recorded nodes and their topological order; replaying recomputes every interior node in place from the
+// current data of the leaves, so no node is allocated, no topology is sorted and no operator runs. Leaves that
+// outlive the pass (parameters, input values updated with set_data) are read afresh on every replay, while
+// leaves created inside the pass are frozen at their recorded values.
+template <typename T>
+class BasicGraphPlan {
+   public:
+    using Scalar = typename BasicValue<T>::Scalar;
+
+   private:
+    using Data = typename BasicValue<T>::Data;
+
+    BasicValue<T> root_;
+    std::vector<Data*> order_;     // Every node, including those that require no gradient, children first
+    std::vector<Data*> interior_;  // Nodes with children
+    std::vector<Data*> backward_;  // The interior nodes backward() propagates through
+
+    explicit BasicGraphPlan(BasicValue<T> root);
+    void set_order();
+
+   public:
+    static BasicGraphPlan capture(const BasicValue<T>& root) { return BasicGraphPlan(root); }
+
+    const BasicValue<T>& root() const noexcept { return root_; }
+    size_t size() const noexcept { return interior_.size(); }
+
+    // Rewrites the captured graph in place:
+    // - Constant folding: leaves that nothing outside the graph refers to (values created inside the step)
+    //   are constants, and every node computed from constants alone becomes one.
+    // - Common-subexpression elimination: nodes with the same op, payload and children, and constants
+    //   with the same value, are merged.
+    // - Pruning: backward() only runs through nodes that require a gradient and, when `parameters` is given,
+    //   reach one of them, so other leaves no longer receive gradients. The parallel backward ignores
+    //   `parameters`.
+    // Forward values are unchanged. Gradients are the same up to rounding, since a merged node sums its
+    // parents' contributions before propagating them. The nodes are the caller's, so Values held elsewhere see
+    // the rewrite: a held folded node becomes a leaf, and a held node merged into another is detached from
+    // the plan, which neither recomputes it nor sends it gradients. Orders cached by backward(true) anywhere
+    // are invalidated.
+    GraphPassReport optimize(const std::vector<BasicValue<T>>& parameters = {});
+
+    // Recomputes the graph from the current leaf data and returns the new root value
+    Scalar forward();
+
+    // Resets the interior gradients and backpropagates from the root; leaf gradients accumulate as in
+    // BasicValue::backward()
+    void backward();
+    void backward(ThreadPool& pool);
+
+    // True if `root` records the same ops over the same leaves, i.e. replaying this plan computes exactly
+    // what the graph below `root` computes and sends gradients to the same places. Leaves that require grad
+    // must be the very same nodes; other leaves only need equal values.
+    bool matches(const BasicValue<T>& root) const;
+};
+
+// A training step whose graph is built by `build`, which returns the loss. The first call runs the step
+// dynamically and captures it; later calls replay the capture. Control flow in `build` that depends on the
+// data can change the graph, which a replay cannot see: every `verify_interval` steps the step is rebuilt and
+// compared with the capture. On a mismatch that step runs on the rebuilt graph and the plan is recaptured from
+// it, or, when `strict`, an exception is thrown instead. By default every step is verified, so a replay never
+// runs a stale graph. A larger interval is an opt-in that replays up to interval - 1 steps of a changed graph
+// before noticing, and 0 never verifies, for steps whose graph is known never to change.
+//
+// Inputs must be external Values that outlive the step and are updated with set_data(). A leaf that `build`
+// creates afresh is frozen at its captured value when it requires no grad, and fails verification on every
+// step when it does, since its gradients could only reach the captured node.
+template <typename T>
+class BasicCapturedStep {
+   public:
+    using Scalar = typename BasicValue<T>::Scalar;
+
+   private:
+    std::function<BasicValue<T>()> build_;
+    std::optional<BasicGraphPlan<T>> plan_;
+    size_t verify_interval_;
+    bool strict_;
+    size_t steps_ = 0;
+    size_t recaptures_ = 0;
+
+    Scalar run_dynamic(BasicValue<T> root);
+
+   public:
+    explicit BasicCapturedStep(std::function<BasicValue<T>()> build, size_t verify_interval = 1,
+                               bool strict = false);
+
+    // Forward and backward of one step; returns the loss
+    Scalar operator()();
+
+    // Drops the capture so that the next step runs dynamically again
+    void reset() noexcept { plan_.reset(); }
+
+    bool captured() const noexcept { return plan_.has_value(); }
+    size_t recaptures() const noexcept { return recaptures_; }
+};
+
+// Defined in graph_plan.cpp for these types only
+extern template class BasicGraphPlan<double>;
+extern template class BasicGraphPlan<float>;
+extern template class BasicGraphPlan<BFloat16>;
+extern template class BasicCapturedStep<double>;
+extern template class BasicCapturedStep<float>;
+extern template class BasicCapturedStep<BFloat16>;
+
+using GraphPlan = BasicGraphPlan<double>;
+using CapturedStep = BasicCapturedStep<double>;
+
+#endif  // CPPGRAD_GRAPH_PLAN_HPP
@@ -0,0 +1,138 @@
+#include "init.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <type_traits>
+
+#include "thread_pool.hpp"
+
+namespace {
+
+std::atomic<std::uint64_t> global_seed{0};
+std::atomic<std::uint64_t> next_stream{0};
+
+constexpr size_t kChunk = 16 * 1024;  // Elements per parallel task
+
+inline void multiply(std::uint32_t a, std::uint32_t b, std::uint32_t& hi, std::uint32_t& lo) noexcept {
+    const std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+    hi = static_cast<std::uint32_t>(product >> 32);
+    lo = static_cast<std::uint32_t>(product);
+}
+
+// 53 random bits as a double in [0, 1)
+inline double unit(std::uint32_t hi, std::uint32_t lo) noexcept {
+    const std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32 | lo) >> 11;
+    return static_cast<double>(bits) * 0x1.0p-53;
+}
+
+template <typename T>
+void fill(Span<T> weights, InitScheme scheme, size_t fan_in, size_t fan_out, const InitStream& stream,
+          ThreadPool* pool) {
+    bool normal = false;
+    double scale = 1.0;  // Bound of the uniform schemes, standard deviation of the normal ones
+    switch (scheme) {
+        case InitScheme::Uniform:
+            break;
+        case InitScheme::XavierUniform:
+            scale = std::sqrt(6.0 / static_cast<double>(fan_in + fan_out));
+            break;
+        case InitScheme::XavierNormal:
+            normal = true;
+            scale = std::sqrt(2.0 / static_cast<double>(fan_in + fan_out));
+            break;
+        case InitScheme::HeUniform:
+            scale = std::sqrt(6.0 / static_cast<double>(fan_in));
+            break;
+        case InitScheme::HeNormal:
+            normal = true;
+            scale = std::sqrt(2.0 / static_cast<double>(fan_in));
+            break;
+    }
+
+    auto store = [&](size_t i, double value) {
+        if constexpr (std::is_same_v<T, double>) {
+            weights[i] = value;
+        } else {
+            weights[i] = T(static_cast<float>(value));
+        }
+    };
+    // Chunks start at even indices, so each pair of elements is written by one task
+    auto fill_range = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i += 2) {
+            const std::array<double, 2> values = normal ? stream.normal_pair(i / 2) : stream.uniform_pair(i / 2);
+            store(i, normal ? scale * values[0] : scale * (2.0 * values[0] - 1.0));
+            if (i + 1 < end) store(i + 1, normal ? scale * values[1] : scale * (2.0 * values[1] - 1.0));
+        }
+    };
+    const size_t chunks = (weights.size() + kChunk - 1) / kChunk;
+    if (pool != nullptr && chunks > 1) {
+        pool->parallel_for(chunks,
+                           [&](size_t c) { fill_range(c * kChunk, std::min(weights.size(), (c + 1) * kChunk)); });
+    } else {
+        fill_range(0, weights.size());
+    }
+}
+
+}  // namespace
+
+Philox::Block Philox::operator()(Block counter) const noexcept {
+    constexpr std::uint32_t kMultiplier0 = 0xD2511F53;
+    constexpr std::uint32_t kMultiplier1 = 0xCD9E8D57;
+    constexpr std::uint32_t kWeyl0 = 0x9E3779B9;
+    constexpr std::uint32_t kWeyl1 = 0xBB67AE85;
+    std::uint32_t key0 = key_[0];
+    std::uint32_t key1 = key_[1];
+    for (int round = 0; round < 10; ++round) {
+        std::uint32_t hi0, lo0, hi1, lo1;
+        multiply(kMultiplier0, counter[0], hi0, lo0);
+        multiply(kMultiplier1, counter[2], hi1, lo1);
+        counter = {hi1 ^ counter[1] ^ key0, lo1, hi0 ^ counter[3] ^ key1, lo0};
+        key0 += kWeyl0;
+        key1 += kWeyl1;
+    }
+    return counter;
+}
+
+void set_init_seed(std::uint64_t seed) noexcept {
+    global_seed.store(seed);
+    next_stream.store(0);
+}
+
+std::uint64_t init_seed() noexcept { return global_seed.load(); }
+
+InitStream InitStream::next() noexcept { return InitStream(global_seed.load(), next_stream.fetch_add(1)); }
+
+Philox::Block InitStream::block(std::uint64_t index) const noexcept {
+    return generator_({static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+                       static_cast<std::uint32_t>(stream_), static_cast<std::uint32_t>(stream_ >> 32)});
+}
+
+std::array<double, 2> InitStream::uniform_pair(std::uint64_t pair) const noexcept {
+    const Philox::Block bits = block(pair);
+    return {unit(bits[0], bits[1]), unit(bits[2], bits[3])};
+}
+
+std::array<double, 2> InitStream::normal_pair(std::uint64_t pair) const noexcept {
+    // Both outputs of the Box-Muller transform
+    constexpr double kTwoPi = 6.283185307179586;
+    const Philox::Block bits = block(pair);
+    const double radius = std::sqrt(-2.0 * std::log(1.0 - unit(bits[0], bits[1])));
+    const double angle = kTwoPi * unit(bits[2], bits[3]);
+    return {radius * std::cos(angle), radius * std::sin(angle)};
+}
+
+void init_weights(Span<double> weights, InitScheme scheme, size_t fan_in, size_t fan_out, const InitStream& stream,
+                  ThreadPool* pool) {
+    fill(weights, scheme, fan_in, fan_out, stream, pool);
+}
+
+void init_weights(Span<float> weights, InitScheme scheme, size_t fan_in, size_t fan_out, const InitStream& stream,
+                  ThreadPool* pool) {
+    fill(weights, scheme, fan_in, fan_out, stream, pool);
+}
+
+void init_weights(Span<BFloat16> weights, InitScheme scheme, size_t fan_in, size_t fan_out,
+                  const InitStream& stream, ThreadPool* pool) {
+    fill(weights, scheme, fan_in, fan_out, stream, pool);
+}
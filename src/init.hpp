@@ -0,0 +1,76 @@
+#ifndef CPPGRAD_INIT_HPP
+#define CPPGRAD_INIT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "bfloat16.hpp"
+#include "span.hpp"
+
+class ThreadPool;
+
+// Distributions for initial weights, given the fan-in and fan-out of the layer they belong to
+enum class InitScheme {
+    Uniform,        // U(-1, 1)
+    XavierUniform,  // U(-a, a), a = sqrt(6 / (fan_in + fan_out))
+    XavierNormal,   // N(0, 2 / (fan_in + fan_out))
+    HeUniform,      // U(-a, a), a = sqrt(6 / fan_in), for ReLU layers
+    HeNormal,       // N(0, 2 / fan_in), for ReLU layers
+};
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): a counter-based generator
+// whose output for a counter is a pure function of (key, counter), so any element of a stream can be drawn
+// independently, in any order and on any thread
+class Philox {
+   private:
+    std::uint32_t key_[2];
+
+   public:
+    using Block = std::array<std::uint32_t, 4>;
+
+    explicit Philox(std::uint64_t key) noexcept
+        : key_{static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)} {}
+
+    Block operator()(Block counter) const noexcept;
+};
+
+// Weight initialization draws from the stream of a global seed. Every module takes the next stream number
+// when constructed, and element i of a stream depends only on (seed, stream, i): building the same modules in
+// the same order after set_init_seed(s) reproduces them exactly, however their weights are filled. The seed
+// is 0 until set.
+void set_init_seed(std::uint64_t seed) noexcept;
+std::uint64_t init_seed() noexcept;
+
+class InitStream {
+   private:
+    Philox generator_;
+    std::uint64_t stream_;
+
+    Philox::Block block(std::uint64_t index) const noexcept;
+
+   public:
+    InitStream(std::uint64_t seed, std::uint64_t stream) noexcept : generator_(seed), stream_(stream) {}
+
+    // The next stream of the global seed
+    static InitStream next() noexcept;
+
+    // Uniform in [0, 1) and standard normal values for element `index`
+    double uniform(std::uint64_t index) const noexcept { return uniform_pair(index / 2)[index % 2]; }
+    double normal(std::uint64_t index) const noexcept { return normal_pair(index / 2)[index % 2]; }
+
+    // Values of elements 2 * pair and 2 * pair + 1, which share one Philox block
+    std::array<double, 2> uniform_pair(std::uint64_t pair) const noexcept;
+    std::array<double, 2> normal_pair(std::uint64_t pair) const noexcept;
+};
+
+// Fills `weights` with element i drawn from `stream` at index i. With a pool, large spans are filled in
+// parallel chunks; the result is the same either way.
+void init_weights(Span<double> weights, InitScheme scheme, size_t fan_in, size_t fan_out, const InitStream& stream,
+                  ThreadPool* pool = nullptr);
+void init_weights(Span<float> weights, InitScheme scheme, size_t fan_in, size_t fan_out, const InitStream& stream,
+                  ThreadPool* pool = nullptr);
+void init_weights(Span<BFloat16> weights, InitScheme scheme, size_t fan_in, size_t fan_out,
+                  const InitStream& stream, ThreadPool* pool = nullptr);
+
+#endif  // CPPGRAD_INIT_HPP
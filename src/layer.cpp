@@ -0,0 +1,52 @@
+#include "layer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "stats.hpp"
+
+Layer::Layer(size_t input_size, size_t output_size, bool use_nonlinearity, InitScheme scheme, ThreadPool* pool)
+    : Layer(input_size, output_size, use_nonlinearity,
+            ParameterBuffer::create(parameter_count(input_size, output_size)), 0, scheme, pool) {}
+
+Layer::Layer(size_t input_size, size_t output_size, bool use_nonlinearity, std::shared_ptr<ParameterBuffer> buffer,
+             size_t offset, InitScheme scheme, ThreadPool* pool)
+    : buffer_(std::move(buffer)),
+      offset_(offset),
+      weights_(buffer_->tensor(offset, {input_size, output_size})),
+      bias_(buffer_->tensor(offset + input_size * output_size, {output_size})),
+      parameters_(buffer_->values(offset, parameter_count(input_size, output_size))),
+      use_nonlinearity_(use_nonlinearity) {
+    init_weights(Span<double>(weights_.data(), weights_.numel()), scheme, input_size, output_size,
+                 InitStream::next(), pool);
+    std::fill(bias_.data(), bias_.data() + bias_.numel(), 0.0);
+}
+
+Layer::Layer(const Layer& layout, std::shared_ptr<ParameterBuffer> buffer)
+    : buffer_(std::move(buffer)),
+      offset_(layout.offset_),
+      weights_(buffer_->tensor(offset_, layout.weights_.shape())),
+      bias_(buffer_->tensor(offset_ + layout.weights_.numel(), layout.bias_.shape())),
+      parameters_(buffer_->values(offset_, layout.parameters_.size())),
+      use_nonlinearity_(layout.use_nonlinearity_) {}
+
+Tensor Layer::operator()(const Tensor& x) const {
+    if (x.ndim() != 2 || x.shape()[1] != input_size()) {
+        throw std::runtime_error("Layer expects input of shape [batch, " + std::to_string(input_size()) + "]");
+    }
+    Tensor activation = x.matmul(weights_) + bias_;
+    return use_nonlinearity_ ? activation.relu() : activation;
+}
+
+std::vector<Value> Layer::parameters() {
+    add_stat(Stat::ParameterCopies);
+    add_stat(Stat::ParametersCopied, parameters_.size());
+    return parameters_;
+}
+
+std::string Layer::str() const {
+    return (use_nonlinearity_ ? "ReLU" : "Linear") + std::string("Layer(") + std::to_string(input_size()) + ", " +
+           std::to_string(output_size()) + ")";
+}
+
+std::ostream& operator<<(std::ostream& os, const Layer& l) { return os << l.str(); }
@@ -0,0 +1,59 @@
+#ifndef CPPGRAD_LAYER_HPP
+#define CPPGRAD_LAYER_HPP
+
+#include <memory>
+#include <vector>
+
+#include "init.hpp"
+#include "module.hpp"
+#include "parameter_buffer.hpp"
+#include "tensor.hpp"
+#include "value.hpp"
+
+// Fully connected layer whose weights live in one contiguous row-major [input_size, output_size] block,
+// directly followed by the bias
+class Layer : public Module {
+   private:
+    std::shared_ptr<ParameterBuffer> buffer_;
+    size_t offset_;
+    Tensor weights_;
+    Tensor bias_;
+    std::vector<Value> parameters_;  // Views of weights_ followed by bias_
+    bool use_nonlinearity_;
+
+    Layer(const Layer& layout, std::shared_ptr<ParameterBuffer> buffer);
+
+   public:
+    // Weights are drawn from the next init stream (init.hpp), filled in parallel on `pool` if given; the bias
+    // starts at zero
+    Layer(size_t input_size, size_t output_size, bool use_nonlinearity = true,
+          InitScheme scheme = InitScheme::Uniform, ThreadPool* pool = nullptr);
+
+    // Places the parameters at `offset` in a buffer shared with other modules
+    Layer(size_t input_size, size_t output_size, bool use_nonlinearity, std::shared_ptr<ParameterBuffer> buffer,
+          size_t offset, InitScheme scheme = InitScheme::Uniform, ThreadPool* pool = nullptr);
+
+    // Same layer over another buffer with an identical layout (e.g. a replica), without reinitialising it
+    Layer rebind(std::shared_ptr<ParameterBuffer> buffer) const { return Layer(*this, std::move(buffer)); }
+
+    static size_t parameter_count(size_t input_size, size_t output_size) noexcept {
+        return input_size * output_size + output_size;
+    }
+
+    // Minibatch forward: [batch, input_size] -> [batch, output_size]
+    Tensor operator()(const Tensor& x) const;
+    std::vector<Value> parameters() override;
+    Span<Value> parameter_view() override { return Span<Value>(parameters_.data(), parameters_.size()); }
+    Span<double> data_buffer() override { return buffer_->data().subspan(offset_, parameters_.size()); }
+    Span<double> grad_buffer() override { return buffer_->grad().subspan(offset_, parameters_.size()); }
+    std::vector<std::vector<size_t>> parameter_shapes() override { return {weights_.shape(), bias_.shape()}; }
+    std::shared_ptr<ParameterBuffer> parameter_buffer() override { return buffer_; }
+
+    size_t input_size() const noexcept { return weights_.shape()[0]; }
+    size_t output_size() const noexcept { return weights_.shape()[1]; }
+
+    std::string str() const;
+    friend std::ostream& operator<<(std::ostream& os, const Layer& l);
+};
+
+#endif  // CPPGRAD_LAYER_HPP
@@ -1,5 +1,6 @@
 #include <iostream>
 
+#include "graph_plan.hpp"
 #include "value.hpp"
 
 int main() {
@@ -8,5 +9,10 @@ int main() {
     Value c = a + b;
     Value d = a + b;
     std::cout << d.data() << std::endl;
+
+    // The two sums are separate nodes until the captured graph is optimized
+    GraphPlan plan = GraphPlan::capture(c * d);
+    GraphPassReport report = plan.optimize();
+    std::cout << "nodes: " << report.nodes_before << " -> " << report.nodes_after << std::endl;
     return 0;
-}
\ No newline at end of file
+}
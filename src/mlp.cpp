@@ -0,0 +1,76 @@
+#include "mlp.hpp"
+
+#include <stdexcept>
+
+#include "stats.hpp"
+
+MLP::MLP(size_t input_size, const std::vector<size_t>& layer_sizes, InitScheme scheme, ThreadPool* pool) {
+    if (layer_sizes.empty()) {
+        throw std::runtime_error("MLP needs at least one layer");
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < layer_sizes.size(); ++i) {
+        total += Layer::parameter_count(i == 0 ? input_size : layer_sizes[i - 1], layer_sizes[i]);
+    }
+    buffer_ = ParameterBuffer::create(total);
+
+    layers_.reserve(layer_sizes.size());
+    size_t offset = 0;
+    for (size_t i = 0; i < layer_sizes.size(); ++i) {
+        size_t layer_input = i == 0 ? input_size : layer_sizes[i - 1];
+        layers_.emplace_back(layer_input, layer_sizes[i], i + 1 < layer_sizes.size(), buffer_, offset, scheme, pool);
+        offset += Layer::parameter_count(layer_input, layer_sizes[i]);
+    }
+    collect_parameters();
+}
+
+MLP MLP::replica() const {
+    MLP copy = *this;
+    copy.buffer_ = ParameterBuffer::replicate(buffer_);
+    for (auto& layer : copy.layers_) {
+        layer = layer.rebind(copy.buffer_);
+    }
+    copy.parameters_.clear();
+    copy.collect_parameters();
+    return copy;
+}
+
+std::vector<std::vector<size_t>> MLP::parameter_shapes() {
+    std::vector<std::vector<size_t>> shapes;
+    for (auto& layer : layers_) {
+        for (auto& shape : layer.parameter_shapes()) shapes.push_back(std::move(shape));
+    }
+    return shapes;
+}
+
+void MLP::collect_parameters() {
+    parameters_.reserve(buffer_->size());
+    for (auto& layer : layers_) {
+        Span<Value> layer_params = layer.parameter_view();
+        parameters_.insert(parameters_.end(), layer_params.begin(), layer_params.end());
+    }
+}
+
+Tensor MLP::operator()(const Tensor& x) const {
+    Tensor activation = x;
+    for (const auto& layer : layers_) {
+        activation = layer(activation);
+    }
+    return activation;
+}
+
+std::vector<Value> MLP::parameters() {
+    add_stat(Stat::ParameterCopies);
+    add_stat(Stat::ParametersCopied, parameters_.size());
+    return parameters_;
+}
+
+std::string MLP::str() const {
+    std::string result = "MLP(";
+    for (size_t i = 0; i < layers_.size(); ++i) {
+        result += (i ? ", " : "") + layers_[i].str();
+    }
+    return result + ")";
+}
+
+std::ostream& operator<<(std::ostream& os, const MLP& m) { return os << m.str(); }
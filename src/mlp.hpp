@@ -0,0 +1,48 @@
+#ifndef CPPGRAD_MLP_HPP
+#define CPPGRAD_MLP_HPP
+
+#include <memory>
+#include <vector>
+
+#include "init.hpp"
+#include "layer.hpp"
+#include "module.hpp"
+#include "parameter_buffer.hpp"
+#include "tensor.hpp"
+#include "value.hpp"
+
+// Stack of Layers with ReLU on every layer but the last; all layers share one flat ParameterBuffer
+class MLP : public Module {
+   private:
+    std::shared_ptr<ParameterBuffer> buffer_;
+    std::vector<Layer> layers_;
+    std::vector<Value> parameters_;
+
+    void collect_parameters();
+
+   public:
+    // Each layer's weights come from its own init stream (init.hpp), filled in parallel on `pool` if given
+    MLP(size_t input_size, const std::vector<size_t>& layer_sizes, InitScheme scheme = InitScheme::Uniform,
+        ThreadPool* pool = nullptr);
+
+    // Shares this MLP's parameter data but has its own grad buffer, so that several threads can run
+    // forward/backward concurrently without racing on gradients
+    MLP replica() const;
+
+    // Minibatch forward: [batch, input_size] -> [batch, layer_sizes.back()]
+    Tensor operator()(const Tensor& x) const;
+    std::vector<Value> parameters() override;
+    Span<Value> parameter_view() override { return Span<Value>(parameters_.data(), parameters_.size()); }
+    Span<double> data_buffer() override { return buffer_->data(); }
+    Span<double> grad_buffer() override { return buffer_->grad(); }
+    std::vector<std::vector<size_t>> parameter_shapes() override;
+    std::shared_ptr<ParameterBuffer> parameter_buffer() override { return buffer_; }
+
+    std::vector<Layer>& layers() noexcept { return layers_; }
+    const std::vector<Layer>& layers() const noexcept { return layers_; }
+
+    std::string str() const;
+    friend std::ostream& operator<<(std::ostream& os, const MLP& m);
+};
+
+#endif  // CPPGRAD_MLP_HPP
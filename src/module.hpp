@@ -1,22 +1,55 @@
 #ifndef CPPGRAD_MODULE_HPP
 #define CPPGRAD_MODULE_HPP
 
+#include <cstring>
+#include <memory>
 #include <vector>
 
+#include "span.hpp"
 #include "value.hpp"
 
-class Module {
+template <typename T>
+class BasicParameterBuffer;
+
+template <typename T>
+class BasicModule {
    public:
-    virtual ~Module() = default;
+    using Scalar = typename BasicValue<T>::Scalar;
+
+    virtual ~BasicModule() = default;
 
     virtual void zero_grad() {
+        Span<Scalar> grad = grad_buffer();
+        if (!grad.empty()) {
+            std::memset(grad.data(), 0, grad.size() * sizeof(Scalar));
+            return;
+        }
         auto params = parameters();
         for (auto& p : params) {
-            p.set_grad(0.0);
+            p.set_grad(0);
         }
     }
 
-    virtual std::vector<Value> parameters() = 0;
+    virtual std::vector<BasicValue<T>> parameters() = 0;
+
+    // Non-owning view over the same Values as parameters(), without copying them. Modules that don't
+    // keep their parameters around return an empty view; use parameters() for those.
+    virtual Span<BasicValue<T>> parameter_view() { return {}; }
+
+    // Flat data and grad of every parameter, in parameters() order, or empty if the module has none
+    virtual Span<T> data_buffer() { return {}; }
+    virtual Span<Scalar> grad_buffer() { return {}; }
+
+    // Shapes of the parameter tensors laid out one after another in data_buffer()
+    virtual std::vector<std::vector<size_t>> parameter_shapes() {
+        const size_t size = data_buffer().size();
+        return size == 0 ? std::vector<std::vector<size_t>>{} : std::vector<std::vector<size_t>>{{size}};
+    }
+
+    // The buffer data_buffer() is a range of, or null if the module has no parameter buffer
+    virtual std::shared_ptr<BasicParameterBuffer<T>> parameter_buffer() { return nullptr; }
 };
 
+using Module = BasicModule<double>;
+
 #endif  // CPPGRAD_MODULE_HPP
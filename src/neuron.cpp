@@ -1,30 +1,91 @@
 #include "neuron.hpp"
 
-#include <numeric>
-#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
 
-Neuron::Neuron(size_t input_size, bool use_nonlinearity) : use_nonlinearity_(use_nonlinearity) {
-    std::random_device random_device;
-    std::mt19937 random_generator(random_device());
-    std::uniform_real_distribution<> distribution(-1.0, 1.0);
+#include "simd.hpp"
+#include "stats.hpp"
 
-    weights_.reserve(input_size + 1);  // +1 for bias
-    for (size_t i = 0; i < input_size; ++i) {
-        weights_.emplace_back(Value(distribution(random_generator)));
+template <typename T>
+BasicNeuron<T>::BasicNeuron(size_t input_size, bool use_nonlinearity, InitScheme scheme)
+    : buffer_(BasicParameterBuffer<T>::create(input_size + 1)),  // +1 for bias
+      weights_(buffer_->values(0, input_size + 1)),
+      use_nonlinearity_(use_nonlinearity) {
+    Span<T> data = buffer_->data();
+    init_weights(data.subspan(0, input_size), scheme, input_size, 1, InitStream::next());
+    data[input_size] = Scalar(0);  // bias initialized to 0
+}
+
+template <typename T>
+BasicValue<T> BasicNeuron<T>::operator()(const std::vector<BasicValue<T>>& inputs) {
+    return BasicValue<T>::linear(weights_, inputs, use_nonlinearity_);
+}
+
+template <typename T>
+const typename BasicNeuron<T>::Scalar* BasicNeuron<T>::compute_weights(std::vector<Scalar>& scratch) const {
+    Span<T> data = buffer_->data();
+    if constexpr (std::is_same_v<T, Scalar>) {
+        return data.data();
+    } else {
+        scratch.assign(data.begin(), data.end());
+        return scratch.data();
+    }
+}
+
+template <typename T>
+void BasicNeuron<T>::forward_batch(const Scalar* inputs, size_t rows, Scalar* outputs) const {
+    const size_t input_size = weights_.size() - 1;
+    std::vector<Scalar> scratch;
+    const Scalar* weights = compute_weights(scratch);
+    const Scalar bias = weights[input_size];
+    for (size_t r = 0; r < rows; ++r) {
+        const Scalar activation = bias + simd_dot(weights, inputs + r * input_size, input_size);
+        outputs[r] = use_nonlinearity_ ? std::max<Scalar>(activation, 0) : activation;
+    }
+}
+
+template <typename T>
+std::vector<typename BasicNeuron<T>::Scalar> BasicNeuron<T>::forward_batch(const std::vector<Scalar>& inputs) const {
+    const size_t input_size = weights_.size() - 1;
+    if (input_size == 0 || inputs.size() % input_size != 0) {
+        throw std::runtime_error("Batch size must be a multiple of the neuron's input size");
     }
-    weights_.emplace_back(Value(0.0));  // bias initialized to 0
+    std::vector<Scalar> outputs(inputs.size() / input_size);
+    forward_batch(inputs.data(), outputs.size(), outputs.data());
+    return outputs;
 }
 
-Value Neuron::operator()(const std::vector<Value>& inputs) {
-    Value activation = weights_.back();  // bias term
-    activation = std::inner_product(weights_.begin(), weights_.end() - 1, inputs.begin(), activation);
-    return use_nonlinearity_ ? activation.relu() : activation;
+template <typename T>
+void BasicNeuron<T>::backward_batch(const Scalar* inputs, size_t rows, const Scalar* outputs,
+                                    const Scalar* output_grads, Scalar* input_grads) {
+    const size_t input_size = weights_.size() - 1;
+    std::vector<Scalar> scratch;
+    const Scalar* weights = compute_weights(scratch);
+    Scalar* grad = buffer_->grad().data();
+    for (size_t r = 0; r < rows; ++r) {
+        const Scalar upstream = (!use_nonlinearity_ || outputs[r] > 0) ? output_grads[r] : Scalar(0);
+        if (upstream == 0) continue;
+        simd_axpy(upstream, inputs + r * input_size, grad, input_size);
+        grad[input_size] += upstream;
+        if (input_grads != nullptr) {
+            simd_axpy(upstream, weights, input_grads + r * input_size, input_size);
+        }
+    }
 }
 
-std::vector<Value> Neuron::parameters() { return weights_; }
+template <typename T>
+std::vector<BasicValue<T>> BasicNeuron<T>::parameters() {
+    add_stat(Stat::ParameterCopies);
+    add_stat(Stat::ParametersCopied, weights_.size());
+    return weights_;
+}
 
-std::string Neuron::str() const {
+template <typename T>
+std::string BasicNeuron<T>::str() const {
     return (use_nonlinearity_ ? "ReLU" : "Linear") + std::string("Neuron(") + std::to_string(weights_.size()) + ")";
 }
 
-std::ostream& operator<<(std::ostream& os, const Neuron& n) { return os << n.str(); }
+template class BasicNeuron<double>;
+template class BasicNeuron<float>;
+template class BasicNeuron<BFloat16>;
@@ -1,25 +1,60 @@
 #ifndef CPPGRAD_NEURON_HPP
 #define CPPGRAD_NEURON_HPP
 
-#include <random>
+#include <memory>
 #include <vector>
 
+#include "init.hpp"
 #include "module.hpp"
+#include "parameter_buffer.hpp"
 #include "value.hpp"
 
-class Neuron : public Module {
+template <typename T>
+class BasicNeuron : public BasicModule<T> {
+   public:
+    using Scalar = typename BasicValue<T>::Scalar;
+
    private:
-    std::vector<Value> weights_;  // Last weight is bias
+    std::shared_ptr<BasicParameterBuffer<T>> buffer_;
+    std::vector<BasicValue<T>> weights_;  // Trainable views into buffer_, last weight is bias
     bool use_nonlinearity_;
 
+    // The weights as contiguous Scalars, converted into `scratch` when T is not its own compute type
+    const Scalar* compute_weights(std::vector<Scalar>& scratch) const;
+
    public:
-    Neuron(size_t input_size, bool use_nonlinearity = true);
+    // Weights are drawn from the next init stream (init.hpp), the bias starts at zero
+    BasicNeuron(size_t input_size, bool use_nonlinearity = true, InitScheme scheme = InitScheme::Uniform);
+
+    BasicValue<T> operator()(const std::vector<BasicValue<T>>& x);
 
-    Value operator()(const std::vector<Value>& x);
-    std::vector<Value> parameters() override;
+    // Batch inference over a row-major [rows, input_size] matrix of raw inputs, one output per row. Uses the
+    // SIMD dot products of simd.hpp and records no graph; results match operator() up to summation order.
+    void forward_batch(const Scalar* inputs, size_t rows, Scalar* outputs) const;
+    std::vector<Scalar> forward_batch(const std::vector<Scalar>& inputs) const;
+
+    // Accumulates into the parameter gradients, and into `input_grads` when given, the gradient of
+    // sum_r output_grads[r] * outputs[r], where `outputs` came from forward_batch() on the same inputs
+    void backward_batch(const Scalar* inputs, size_t rows, const Scalar* outputs, const Scalar* output_grads,
+                        Scalar* input_grads = nullptr);
+    std::vector<BasicValue<T>> parameters() override;
+    Span<BasicValue<T>> parameter_view() override { return Span<BasicValue<T>>(weights_.data(), weights_.size()); }
+    Span<T> data_buffer() override { return buffer_->data(); }
+    Span<Scalar> grad_buffer() override { return buffer_->grad(); }
+    std::vector<std::vector<size_t>> parameter_shapes() override { return {{weights_.size() - 1}, {1}}; }
+    std::shared_ptr<BasicParameterBuffer<T>> parameter_buffer() override { return buffer_; }
 
     std::string str() const;
-    friend std::ostream& operator<<(std::ostream& os, const Neuron& n);
+    friend std::ostream& operator<<(std::ostream& os, const BasicNeuron& n) { return os << n.str(); }
 };
 
+// Defined in neuron.cpp for the same types as BasicValue
+extern template class BasicNeuron<double>;
+extern template class BasicNeuron<float>;
+extern template class BasicNeuron<BFloat16>;
+
+using Neuron = BasicNeuron<double>;
+using FloatNeuron = BasicNeuron<float>;
+using BFloat16Neuron = BasicNeuron<BFloat16>;
+
 #endif  // CPPGRAD_NEURON_HPP
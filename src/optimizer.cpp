@@ -0,0 +1,86 @@
+#include "optimizer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+Optimizer::Optimizer(Module& module) : data_(module.data_buffer()), grad_(module.grad_buffer()) {
+    if (data_.empty() && !module.parameters().empty()) {
+        throw std::runtime_error("Optimizer requires a module with flat parameter buffers");
+    }
+}
+
+void Optimizer::zero_grad() noexcept {
+    if (!grad_.empty()) std::memset(grad_.data(), 0, grad_.size() * sizeof(double));
+}
+
+SGD::SGD(Module& module, double learning_rate, double momentum, double weight_decay)
+    : Optimizer(module),
+      learning_rate_(learning_rate),
+      momentum_(momentum),
+      weight_decay_(weight_decay),
+      velocity_(momentum != 0.0 ? data_.size() : 0) {}
+
+void SGD::step() {
+    double* data = data_.data();
+    const double* grad = grad_.data();
+    const size_t n = data_.size();
+    const double lr = learning_rate_;
+    const double decay = weight_decay_;
+
+    if (momentum_ == 0.0) {
+        for (size_t i = 0; i < n; ++i) {
+            data[i] -= lr * (grad[i] + decay * data[i]);
+        }
+        return;
+    }
+
+    double* velocity = velocity_.data();
+    const double mu = momentum_;
+    for (size_t i = 0; i < n; ++i) {
+        velocity[i] = mu * velocity[i] + grad[i] + decay * data[i];
+        data[i] -= lr * velocity[i];
+    }
+}
+
+Adam::Adam(Module& module, double learning_rate, double beta1, double beta2, double epsilon, double weight_decay)
+    : Adam(module, learning_rate, beta1, beta2, epsilon, weight_decay, false) {}
+
+Adam::Adam(Module& module, double learning_rate, double beta1, double beta2, double epsilon, double weight_decay,
+           bool decoupled_weight_decay)
+    : Optimizer(module),
+      learning_rate_(learning_rate),
+      beta1_(beta1),
+      beta2_(beta2),
+      epsilon_(epsilon),
+      weight_decay_(weight_decay),
+      decoupled_weight_decay_(decoupled_weight_decay),
+      first_moment_(data_.size()),
+      second_moment_(data_.size()) {}
+
+void Adam::step() {
+    ++steps_;
+    double* data = data_.data();
+    const double* grad = grad_.data();
+    double* m = first_moment_.data();
+    double* v = second_moment_.data();
+    const size_t n = data_.size();
+
+    const double b1 = beta1_;
+    const double b2 = beta2_;
+    const double eps = epsilon_;
+    const double step_size = learning_rate_ / (1.0 - std::pow(b1, static_cast<double>(steps_)));
+    const double inv_sqrt_correction = 1.0 / std::sqrt(1.0 - std::pow(b2, static_cast<double>(steps_)));
+    const double l2 = decoupled_weight_decay_ ? 0.0 : weight_decay_;
+    const double shrink = decoupled_weight_decay_ ? 1.0 - learning_rate_ * weight_decay_ : 1.0;
+
+    for (size_t i = 0; i < n; ++i) {
+        const double g = grad[i] + l2 * data[i];
+        m[i] = b1 * m[i] + (1.0 - b1) * g;
+        v[i] = b2 * v[i] + (1.0 - b2) * g * g;
+        data[i] = shrink * data[i] - step_size * m[i] / (std::sqrt(v[i]) * inv_sqrt_correction + eps);
+    }
+}
+
+AdamW::AdamW(Module& module, double learning_rate, double beta1, double beta2, double epsilon, double weight_decay)
+    : Adam(module, learning_rate, beta1, beta2, epsilon, weight_decay, true) {}
@@ -0,0 +1,69 @@
+#ifndef CPPGRAD_OPTIMIZER_HPP
+#define CPPGRAD_OPTIMIZER_HPP
+
+#include <cstdint>
+
+#include "aligned_allocator.hpp"
+#include "module.hpp"
+#include "span.hpp"
+
+// Updates a module's parameters in place through its flat data/grad buffers, one pass per step.
+// The module must outlive the optimizer.
+class Optimizer {
+   protected:
+    Span<double> data_;
+    Span<double> grad_;
+
+   public:
+    explicit Optimizer(Module& module);
+    virtual ~Optimizer() = default;
+
+    virtual void step() = 0;
+    void zero_grad() noexcept;
+
+    size_t size() const noexcept { return data_.size(); }
+};
+
+// Stochastic gradient descent with optional heavy-ball momentum and L2 weight decay
+class SGD : public Optimizer {
+   private:
+    double learning_rate_;
+    double momentum_;
+    double weight_decay_;
+    AlignedVector<double> velocity_;
+
+   public:
+    SGD(Module& module, double learning_rate, double momentum = 0.0, double weight_decay = 0.0);
+    void step() override;
+};
+
+// Adam with bias correction; weight_decay is added to the gradient (L2)
+class Adam : public Optimizer {
+   protected:
+    double learning_rate_;
+    double beta1_;
+    double beta2_;
+    double epsilon_;
+    double weight_decay_;
+    bool decoupled_weight_decay_;
+    std::uint64_t steps_ = 0;
+    AlignedVector<double> first_moment_;
+    AlignedVector<double> second_moment_;
+
+    Adam(Module& module, double learning_rate, double beta1, double beta2, double epsilon, double weight_decay,
+         bool decoupled_weight_decay);
+
+   public:
+    explicit Adam(Module& module, double learning_rate = 1e-3, double beta1 = 0.9, double beta2 = 0.999,
+                  double epsilon = 1e-8, double weight_decay = 0.0);
+    void step() override;
+};
+
+// Adam with weight decay applied directly to the parameters instead of the gradient
+class AdamW : public Adam {
+   public:
+    explicit AdamW(Module& module, double learning_rate = 1e-3, double beta1 = 0.9, double beta2 = 0.999,
+                   double epsilon = 1e-8, double weight_decay = 1e-2);
+};
+
+#endif  // CPPGRAD_OPTIMIZER_HPP
@@ -0,0 +1,93 @@
+#include "page_storage.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+size_t PageStorage::page_size() noexcept {
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+void PageStorage::read(int fd, size_t file_offset, void* out, size_t bytes) {
+    auto p = static_cast<char*>(out);
+    while (bytes > 0) {
+        const ssize_t n = ::pread(fd, p, bytes, static_cast<off_t>(file_offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            throw std::runtime_error(std::string("Failed to read file: ") + std::strerror(errno));
+        }
+        if (n == 0) {
+            throw std::runtime_error("Unexpected end of file");
+        }
+        p += n;
+        file_offset += static_cast<size_t>(n);
+        bytes -= static_cast<size_t>(n);
+    }
+}
+
+PageStorage::PageStorage(size_t bytes) {
+    if (bytes == 0) return;
+    const size_t page = page_size();
+    const size_t size = (bytes + page - 1) / page * page;
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    data_ = data;
+    size_ = size;
+}
+
+PageStorage::~PageStorage() {
+    if (data_ != nullptr) ::munmap(data_, size_);
+}
+
+PageStorage::PageStorage(PageStorage&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+PageStorage& PageStorage::operator=(PageStorage&& other) noexcept {
+    if (this != &other) {
+        if (data_ != nullptr) ::munmap(data_, size_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+size_t PageStorage::load(size_t offset, int fd, size_t file_offset, size_t bytes) {
+    if (offset > size_ || bytes > size_ - offset) {
+        throw std::runtime_error("File load out of range of page storage");
+    }
+    char* begin = static_cast<char*>(data_) + offset;
+    const size_t page = page_size();
+    // Pages can only be mapped where page boundaries in memory fall on page boundaries in the file
+    if ((reinterpret_cast<std::uintptr_t>(begin) - file_offset) % page != 0) {
+        read(fd, file_offset, begin, bytes);
+        return 0;
+    }
+    const size_t head = (page - reinterpret_cast<std::uintptr_t>(begin) % page) % page;
+    if (head >= bytes) {
+        read(fd, file_offset, begin, bytes);
+        return 0;
+    }
+    const size_t mapped = (bytes - head) / page * page;
+    if (mapped > 0) {
+        void* pages = ::mmap(begin + head, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd,
+                             static_cast<off_t>(file_offset + head));
+        if (pages == MAP_FAILED) {
+            // The range is still our anonymous mapping; fall back to reading it
+            read(fd, file_offset, begin, bytes);
+            return 0;
+        }
+    }
+    read(fd, file_offset, begin, head);
+    read(fd, file_offset + head + mapped, begin + head + mapped, bytes - head - mapped);
+    return mapped;
+}
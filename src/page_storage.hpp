@@ -0,0 +1,38 @@
+#ifndef CPPGRAD_PAGE_STORAGE_HPP
+#define CPPGRAD_PAGE_STORAGE_HPP
+
+#include <cstddef>
+
+// Zeroed, page-aligned memory mapped straight from the OS. Unlike heap memory, whole pages of it can later be
+// replaced by a private mapping of a file, which loads the file into place lazily and without a copy while
+// every pointer into the storage stays valid.
+class PageStorage {
+   private:
+    void* data_ = nullptr;
+    size_t size_ = 0;  // Mapped bytes, a whole number of pages
+
+   public:
+    static size_t page_size() noexcept;
+
+    // Reads exactly `bytes` at `file_offset` of `fd` into `out`, throwing on errors and short files
+    static void read(int fd, size_t file_offset, void* out, size_t bytes);
+
+    PageStorage() = default;
+    explicit PageStorage(size_t bytes);
+    ~PageStorage();
+    PageStorage(PageStorage&& other) noexcept;
+    PageStorage& operator=(PageStorage&& other) noexcept;
+    PageStorage(const PageStorage&) = delete;
+    PageStorage& operator=(const PageStorage&) = delete;
+
+    void* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+    // Fills [offset, offset + bytes) with the file's bytes from `file_offset`. Whole pages are mapped
+    // copy-on-write when the storage and file offsets agree modulo the page size, so writes never reach the
+    // file; the rest is read. Returns the number of bytes mapped. The file must not be truncated while
+    // mapped; replacing it by rename, as checkpoints are saved, is safe.
+    size_t load(size_t offset, int fd, size_t file_offset, size_t bytes);
+};
+
+#endif  // CPPGRAD_PAGE_STORAGE_HPP
@@ -0,0 +1,106 @@
+#ifndef CPPGRAD_PARAMETER_BUFFER_HPP
+#define CPPGRAD_PARAMETER_BUFFER_HPP
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "aligned_allocator.hpp"
+#include "page_storage.hpp"
+#include "span.hpp"
+#include "tensor.hpp"
+#include "value.hpp"
+
+// Flat, contiguous data and grad storage for the parameters of one or more modules. Parameters are
+// Value/Tensor views into it, so zero_grad() is one memset and optimizers can update everything in bulk.
+// Data is stored as T and grads in its compute type, matching BasicValue<T>.
+template <typename T>
+class BasicParameterBuffer : public std::enable_shared_from_this<BasicParameterBuffer<T>> {
+   public:
+    using Scalar = typename BasicValue<T>::Scalar;
+
+   private:
+    // Data of at least this size lives in page storage, which files can be mapped into (load_file)
+    static constexpr size_t kPageStorageBytes = 64 * 1024;
+
+    AlignedVector<T> data_storage_;  // Empty for replicas, which read the source buffer's data, and large buffers
+    PageStorage pages_;
+    AlignedVector<Scalar> grad_;
+    std::shared_ptr<BasicParameterBuffer> source_;
+    T* data_;
+
+    explicit BasicParameterBuffer(size_t size) : grad_(size) {
+        if (size * sizeof(T) >= kPageStorageBytes) {
+            pages_ = PageStorage(size * sizeof(T));
+            data_ = static_cast<T*>(pages_.data());
+        } else {
+            data_storage_.resize(size);
+            data_ = data_storage_.data();
+        }
+    }
+    explicit BasicParameterBuffer(std::shared_ptr<BasicParameterBuffer> source)
+        : grad_(source->size()), source_(std::move(source)), data_(source_->data_) {}
+
+   public:
+    static std::shared_ptr<BasicParameterBuffer> create(size_t size) {
+        return std::shared_ptr<BasicParameterBuffer>(new BasicParameterBuffer(size));
+    }
+
+    // Shares `source`'s data but accumulates into its own zeroed grad, e.g. one per training worker
+    static std::shared_ptr<BasicParameterBuffer> replicate(std::shared_ptr<BasicParameterBuffer> source) {
+        return std::shared_ptr<BasicParameterBuffer>(new BasicParameterBuffer(std::move(source)));
+    }
+
+    size_t size() const noexcept { return grad_.size(); }
+    Span<T> data() noexcept { return Span<T>(data_, grad_.size()); }
+    Span<Scalar> grad() noexcept { return Span<Scalar>(grad_.data(), grad_.size()); }
+
+    void zero_grad() noexcept {
+        if (!grad_.empty()) std::memset(grad_.data(), 0, grad_.size() * sizeof(Scalar));
+    }
+
+    // Overwrites data [offset, offset + count) with values stored at `file_offset` in `fd`, in place, so
+    // existing views see them. Large buffers map whole pages of the file copy-on-write instead of reading
+    // them (PageStorage::load); returns true if any were mapped.
+    bool load_file(int fd, size_t file_offset, size_t offset, size_t count) {
+        if (source_) return source_->load_file(fd, file_offset, offset, count);
+        if (offset + count > size()) {
+            throw std::runtime_error("Parameter load out of range");
+        }
+        if (pages_.data() != nullptr) {
+            return pages_.load(offset * sizeof(T), fd, file_offset, count * sizeof(T)) > 0;
+        }
+        PageStorage::read(fd, file_offset, data_ + offset, count * sizeof(T));
+        return false;
+    }
+
+    // Views over [offset, offset + count); they keep the buffer alive
+    std::vector<BasicValue<T>> values(size_t offset, size_t count) {
+        if (offset + count > size()) {
+            throw std::runtime_error("Parameter view out of range");
+        }
+        std::shared_ptr<BasicParameterBuffer> owner = this->shared_from_this();
+        std::vector<BasicValue<T>> views;
+        views.reserve(count);
+        for (size_t i = offset; i < offset + count; ++i) {
+            views.push_back(BasicValue<T>::view(data_[i], grad_[i], owner));
+        }
+        return views;
+    }
+
+    Tensor tensor(size_t offset, std::vector<size_t> shape) {
+        static_assert(std::is_same_v<T, double>, "Tensors are double precision");
+        size_t count = 1;
+        for (size_t dim : shape) count *= dim;
+        if (offset + count > size()) {
+            throw std::runtime_error("Parameter view out of range");
+        }
+        return Tensor::view(std::move(shape), data_ + offset, grad_.data() + offset, this->shared_from_this());
+    }
+};
+
+using ParameterBuffer = BasicParameterBuffer<double>;
+
+#endif  // CPPGRAD_PARAMETER_BUFFER_HPP
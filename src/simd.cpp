@@ -0,0 +1,222 @@
+#include "simd.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CPPGRAD_SIMD_X86 1
+#endif
+
+namespace {
+
+template <typename S>
+S dot_scalar(const S* x, const S* y, size_t n) noexcept {
+    S sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += x[i] * y[i];
+    return sum;
+}
+
+template <typename S>
+void axpy_scalar(S alpha, const S* x, S* y, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) y[i] += alpha * x[i];
+}
+
+#ifdef CPPGRAD_SIMD_X86
+
+// Two accumulators hide the FMA latency; the tail is finished with scalar code
+
+__attribute__((target("avx2,fma"))) double dot_avx2(const double* x, const double* y, size_t n) noexcept {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), acc1);
+    }
+    if (i + 4 <= n) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc0);
+        i += 4;
+    }
+    acc0 = _mm256_add_pd(acc0, acc1);
+    __m128d sum2 = _mm_add_pd(_mm256_castpd256_pd128(acc0), _mm256_extractf128_pd(acc0, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(sum2, _mm_unpackhi_pd(sum2, sum2)));
+    for (; i < n; ++i) sum += x[i] * y[i];
+    return sum;
+}
+
+__attribute__((target("avx2,fma"))) float dot_avx2(const float* x, const float* y, size_t n) noexcept {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), acc1);
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), acc0);
+        i += 8;
+    }
+    acc0 = _mm256_add_ps(acc0, acc1);
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+    __m128 sum2 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    float sum = _mm_cvtss_f32(_mm_add_ss(sum2, _mm_shuffle_ps(sum2, sum2, 1)));
+    for (; i < n; ++i) sum += x[i] * y[i];
+    return sum;
+}
+
+__attribute__((target("avx2,fma"))) void axpy_avx2(double alpha, const double* x, double* y, size_t n) noexcept {
+    const __m256d a = _mm256_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    for (; i < n; ++i) y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx2,fma"))) void axpy_avx2(float alpha, const float* x, float* y, size_t n) noexcept {
+    const __m256 a = _mm256_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; ++i) y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx512f"))) double dot_avx512(const double* x, const double* y, size_t n) noexcept {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), acc1);
+    }
+    for (; i < n; i += 8) {  // Masked loads cover the tail
+        const __mmask8 mask = n - i >= 8 ? __mmask8(0xFF) : static_cast<__mmask8>((1u << (n - i)) - 1);
+        acc0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), acc0);
+    }
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, _mm512_add_pd(acc0, acc1));
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+__attribute__((target("avx512f"))) float dot_avx512(const float* x, const float* y, size_t n) noexcept {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), acc1);
+    }
+    for (; i < n; i += 16) {
+        const __mmask16 mask = n - i >= 16 ? __mmask16(0xFFFF) : static_cast<__mmask16>((1u << (n - i)) - 1);
+        acc0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), acc0);
+    }
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, _mm512_add_ps(acc0, acc1));
+    float sum = 0;
+    for (float lane : lanes) sum += lane;
+    return sum;
+}
+
+__attribute__((target("avx512f"))) void axpy_avx512(double alpha, const double* x, double* y, size_t n) noexcept {
+    const __m512d a = _mm512_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    }
+    if (i < n) {
+        const __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_pd(y + i, tail,
+                              _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(tail, x + i), _mm512_maskz_loadu_pd(tail, y + i)));
+    }
+}
+
+__attribute__((target("avx512f"))) void axpy_avx512(float alpha, const float* x, float* y, size_t n) noexcept {
+    const __m512 a = _mm512_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(y + i, _mm512_fmadd_ps(a, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    }
+    if (i < n) {
+        const __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(y + i, tail,
+                              _mm512_fmadd_ps(a, _mm512_maskz_loadu_ps(tail, x + i), _mm512_maskz_loadu_ps(tail, y + i)));
+    }
+}
+
+#endif  // CPPGRAD_SIMD_X86
+
+struct Kernels {
+    double (*dot_f64)(const double*, const double*, size_t) noexcept;
+    float (*dot_f32)(const float*, const float*, size_t) noexcept;
+    void (*axpy_f64)(double, const double*, double*, size_t) noexcept;
+    void (*axpy_f32)(float, const float*, float*, size_t) noexcept;
+};
+
+const Kernels& kernels_for(SimdLevel level) noexcept {
+    static const Kernels scalar = {&dot_scalar<double>, &dot_scalar<float>, &axpy_scalar<double>, &axpy_scalar<float>};
+#ifdef CPPGRAD_SIMD_X86
+    static const Kernels avx2 = {&dot_avx2, &dot_avx2, &axpy_avx2, &axpy_avx2};
+    static const Kernels avx512 = {&dot_avx512, &dot_avx512, &axpy_avx512, &axpy_avx512};
+    if (level == SimdLevel::AVX512) return avx512;
+    if (level == SimdLevel::AVX2) return avx2;
+#endif
+    (void)level;
+    return scalar;
+}
+
+SimdLevel detect_simd_level() noexcept {
+#ifdef CPPGRAD_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const SimdLevel supported = detect_simd_level();
+std::atomic<const Kernels*> active{&kernels_for(supported)};
+std::atomic<SimdLevel> active_level{supported};
+
+}  // namespace
+
+SimdLevel supported_simd_level() noexcept {
+    return supported;
+}
+
+SimdLevel simd_level() noexcept {
+    return active_level.load(std::memory_order_relaxed);
+}
+
+void set_simd_level(SimdLevel level) noexcept {
+    if (static_cast<int>(level) > static_cast<int>(supported)) level = supported;
+    active_level.store(level, std::memory_order_relaxed);
+    active.store(&kernels_for(level), std::memory_order_relaxed);
+}
+
+const char* simd_level_name(SimdLevel level) noexcept {
+    switch (level) {
+        case SimdLevel::AVX512:
+            return "AVX-512";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        default:
+            return "scalar";
+    }
+}
+
+double simd_dot(const double* x, const double* y, size_t n) noexcept {
+    return active.load(std::memory_order_relaxed)->dot_f64(x, y, n);
+}
+
+float simd_dot(const float* x, const float* y, size_t n) noexcept {
+    return active.load(std::memory_order_relaxed)->dot_f32(x, y, n);
+}
+
+void simd_axpy(double alpha, const double* x, double* y, size_t n) noexcept {
+    active.load(std::memory_order_relaxed)->axpy_f64(alpha, x, y, n);
+}
+
+void simd_axpy(float alpha, const float* x, float* y, size_t n) noexcept {
+    active.load(std::memory_order_relaxed)->axpy_f32(alpha, x, y, n);
+}
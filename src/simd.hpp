@@ -0,0 +1,24 @@
+#ifndef CPPGRAD_SIMD_HPP
+#define CPPGRAD_SIMD_HPP
+
+#include <cstddef>
+
+// Dot products and axpy over contiguous arrays. The widest instruction set the CPU supports is picked once at
+// startup (AVX-512, else AVX2 with FMA, else a scalar loop); vector kernels reassociate the sums.
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+SimdLevel supported_simd_level() noexcept;
+SimdLevel simd_level() noexcept;
+
+// Caps the kernels at `level` (clamped to what the CPU supports), e.g. to compare against the scalar path
+void set_simd_level(SimdLevel level) noexcept;
+const char* simd_level_name(SimdLevel level) noexcept;
+
+double simd_dot(const double* x, const double* y, size_t n) noexcept;
+float simd_dot(const float* x, const float* y, size_t n) noexcept;
+
+// y += alpha * x
+void simd_axpy(double alpha, const double* x, double* y, size_t n) noexcept;
+void simd_axpy(float alpha, const float* x, float* y, size_t n) noexcept;
+
+#endif  // CPPGRAD_SIMD_HPP
@@ -0,0 +1,28 @@
+#ifndef CPPGRAD_SPAN_HPP
+#define CPPGRAD_SPAN_HPP
+
+#include <cstddef>
+
+// Non-owning view over a contiguous range (std::span is C++20)
+template <typename T>
+class Span {
+   private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+
+   public:
+    Span() noexcept = default;
+    Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    T* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    T& operator[](size_t index) const noexcept { return data_[index]; }
+    T* begin() const noexcept { return data_; }
+    T* end() const noexcept { return data_ + size_; }
+
+    Span subspan(size_t offset, size_t count) const noexcept { return Span(data_ + offset, count); }
+};
+
+#endif  // CPPGRAD_SPAN_HPP
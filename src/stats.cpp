@@ -0,0 +1,64 @@
+#include "stats.hpp"
+
+#include <array>
+#include <cstdio>
+
+namespace {
+
+std::array<std::atomic<std::uint64_t>, static_cast<size_t>(Stat::Count)> counters{};
+
+std::uint64_t load(Stat stat) noexcept {
+    return counters[static_cast<size_t>(stat)].load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+std::atomic<std::uint64_t>& stats_detail::counter(Stat stat) noexcept { return counters[static_cast<size_t>(stat)]; }
+
+EngineStats engine_stats() noexcept {
+    EngineStats stats;
+    stats.leaves_created = load(Stat::LeavesCreated);
+    stats.ops_recorded = load(Stat::OpsRecorded);
+    stats.node_bytes = load(Stat::NodeBytes);
+    stats.backward_calls = load(Stat::BackwardCalls);
+    stats.backward_nodes = load(Stat::BackwardNodes);
+    stats.topo_sorts = load(Stat::TopoSorts);
+    stats.topo_sort_ns = load(Stat::TopoSortNs);
+    stats.backward_ns = load(Stat::BackwardNs);
+    stats.parameter_copies = load(Stat::ParameterCopies);
+    stats.parameters_copied = load(Stat::ParametersCopied);
+    return stats;
+}
+
+void reset_engine_stats() noexcept {
+    for (auto& counter : counters) counter.store(0, std::memory_order_relaxed);
+}
+
+EngineStats EngineStats::operator-(const EngineStats& other) const noexcept {
+    EngineStats diff;
+    diff.leaves_created = leaves_created - other.leaves_created;
+    diff.ops_recorded = ops_recorded - other.ops_recorded;
+    diff.node_bytes = node_bytes - other.node_bytes;
+    diff.backward_calls = backward_calls - other.backward_calls;
+    diff.backward_nodes = backward_nodes - other.backward_nodes;
+    diff.topo_sorts = topo_sorts - other.topo_sorts;
+    diff.topo_sort_ns = topo_sort_ns - other.topo_sort_ns;
+    diff.backward_ns = backward_ns - other.backward_ns;
+    diff.parameter_copies = parameter_copies - other.parameter_copies;
+    diff.parameters_copied = parameters_copied - other.parameters_copied;
+    return diff;
+}
+
+std::string EngineStats::str() const {
+    char buffer[320];
+    std::snprintf(buffer, sizeof(buffer),
+                  "leaves=%llu ops=%llu node_bytes=%llu backward_calls=%llu backward_nodes=%llu topo_sorts=%llu "
+                  "topo_sort_us=%.1f backward_us=%.1f parameter_copies=%llu parameters_copied=%llu",
+                  static_cast<unsigned long long>(leaves_created), static_cast<unsigned long long>(ops_recorded),
+                  static_cast<unsigned long long>(node_bytes), static_cast<unsigned long long>(backward_calls),
+                  static_cast<unsigned long long>(backward_nodes), static_cast<unsigned long long>(topo_sorts),
+                  static_cast<double>(topo_sort_ns) / 1000.0, static_cast<double>(backward_ns) / 1000.0,
+                  static_cast<unsigned long long>(parameter_copies),
+                  static_cast<unsigned long long>(parameters_copied));
+    return buffer;
+}
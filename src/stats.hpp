@@ -0,0 +1,105 @@
+#ifndef CPPGRAD_STATS_HPP
+#define CPPGRAD_STATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Runtime counters of the autodiff engine. They are opt-in: configure with -DCPPGRAD_STATS=ON (which defines
+// CPPGRAD_STATS=1 for every target) to record them; otherwise every hook below compiles to nothing and the
+// stats read as zero. Counters are process-wide and relaxed, so concurrent steps are attributed together.
+#ifndef CPPGRAD_STATS
+#define CPPGRAD_STATS 0
+#endif
+
+inline constexpr bool kStatsEnabled = CPPGRAD_STATS != 0;
+
+enum class Stat : unsigned {
+    LeavesCreated,     // Nodes without children: inputs, constants, no-grad results (not parameter views)
+    OpsRecorded,       // Interior nodes, i.e. recorded ops with their backward rule
+    NodeBytes,         // Bytes of the nodes above and their child arrays
+    BackwardCalls,     // Value::backward() calls, serial or parallel
+    BackwardNodes,     // Nodes visited by those calls
+    TopoSorts,         // Topological sorts actually run (a reused topology is not counted)
+    TopoSortNs,        // Time spent sorting
+    BackwardNs,        // Time spent propagating gradients, excluding the sort
+    ParameterCopies,   // Module::parameters() calls
+    ParametersCopied,  // Values copied by those calls
+    Count
+};
+
+// A snapshot of the counters, or the difference of two snapshots
+struct EngineStats {
+    std::uint64_t leaves_created = 0;
+    std::uint64_t ops_recorded = 0;
+    std::uint64_t node_bytes = 0;
+    std::uint64_t backward_calls = 0;
+    std::uint64_t backward_nodes = 0;
+    std::uint64_t topo_sorts = 0;
+    std::uint64_t topo_sort_ns = 0;
+    std::uint64_t backward_ns = 0;
+    std::uint64_t parameter_copies = 0;
+    std::uint64_t parameters_copied = 0;
+
+    std::uint64_t nodes_created() const noexcept { return leaves_created + ops_recorded; }
+
+    EngineStats operator-(const EngineStats& other) const noexcept;
+
+    // One line of "name=value" pairs, times in microseconds
+    std::string str() const;
+};
+
+EngineStats engine_stats() noexcept;
+void reset_engine_stats() noexcept;
+
+namespace stats_detail {
+std::atomic<std::uint64_t>& counter(Stat stat) noexcept;
+}
+
+inline void add_stat(Stat stat, std::uint64_t amount = 1) noexcept {
+    if constexpr (kStatsEnabled) {
+        stats_detail::counter(stat).fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+// Adds the nanoseconds from construction to destruction to a time counter
+class StatTimer {
+   public:
+    explicit StatTimer(Stat stat) noexcept : stat_(stat) {
+        if constexpr (kStatsEnabled) start_ = std::chrono::steady_clock::now();
+    }
+    ~StatTimer() {
+        if constexpr (kStatsEnabled) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            add_stat(stat_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+    StatTimer(const StatTimer&) = delete;
+    StatTimer& operator=(const StatTimer&) = delete;
+
+   private:
+    Stat stat_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// The counters accumulated since construction, e.g. around one training step:
+//   StepStats step;
+//   ... forward, backward, optimizer ...
+//   log(step.report());
+class StepStats {
+   public:
+    StepStats() noexcept : start_(engine_stats()) {}
+
+    EngineStats stats() const noexcept { return engine_stats() - start_; }
+    std::string report() const { return stats().str(); }
+
+    // Starts a new step from the current counters
+    void restart() noexcept { start_ = engine_stats(); }
+
+   private:
+    EngineStats start_;
+};
+
+#endif  // CPPGRAD_STATS_HPP
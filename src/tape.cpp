@@ -0,0 +1,143 @@
+#include "tape.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+TapeValue Tape::push(OpCode op, double data, std::uint32_t lhs, std::uint32_t rhs) {
+    if (records_.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Tape is full");
+    }
+    records_.push_back({op, lhs, rhs, data, 0.0});
+    return TapeValue(this, static_cast<std::uint32_t>(records_.size() - 1));
+}
+
+TapeValue Tape::variable(double data) { return push(OpCode::Leaf, data); }
+
+void Tape::backward(const TapeValue& root) {
+    if (root.tape_ != this) {
+        throw std::runtime_error("Value does not belong to this tape");
+    }
+
+    Record* records = records_.data();
+    for (std::uint32_t i = 0; i < root.index_; ++i) {
+        if (records[i].op != OpCode::Leaf) records[i].grad = 0.0;
+    }
+    records[root.index_].grad = 1.0;
+
+    for (std::uint32_t i = root.index_ + 1; i-- > 0;) {
+        const Record& node = records[i];
+        const double grad = node.grad;
+        switch (node.op) {
+            case OpCode::Leaf:
+            case OpCode::Constant:
+                break;
+            case OpCode::Add:
+                records[node.lhs].grad += grad;
+                records[node.rhs].grad += grad;
+                break;
+            case OpCode::Sub:
+                records[node.lhs].grad += grad;
+                records[node.rhs].grad -= grad;
+                break;
+            case OpCode::Mul:
+                records[node.lhs].grad += records[node.rhs].data * grad;
+                records[node.rhs].grad += records[node.lhs].data * grad;
+                break;
+            case OpCode::Div: {
+                const double lhs = records[node.lhs].data;
+                const double rhs = records[node.rhs].data;
+                records[node.lhs].grad += grad / rhs;
+                records[node.rhs].grad -= grad * lhs / (rhs * rhs);
+                break;
+            }
+            case OpCode::Pow: {
+                const double exponent = records[node.rhs].data;
+                records[node.lhs].grad += exponent * std::pow(records[node.lhs].data, exponent - 1) * grad;
+                break;
+            }
+            case OpCode::ReLU:
+                records[node.lhs].grad += (records[node.lhs].data > 0) ? grad : 0.0;
+                break;
+        }
+    }
+}
+
+void Tape::zero_grad() noexcept {
+    for (auto& record : records_) {
+        record.grad = 0.0;
+    }
+}
+
+void Tape::clear() noexcept { records_.clear(); }
+
+std::string Tape::op_name(OpCode op) {
+    switch (op) {
+        case OpCode::Add:
+            return "+";
+        case OpCode::Sub:
+            return "-";
+        case OpCode::Mul:
+            return "*";
+        case OpCode::Div:
+            return "/";
+        case OpCode::Pow:
+            return "pow";
+        case OpCode::ReLU:
+            return "ReLU";
+        default:
+            return "";
+    }
+}
+
+void TapeValue::check_same_tape(const TapeValue& other) const {
+    if (tape_ != other.tape_) {
+        throw std::runtime_error("Values belong to different tapes");
+    }
+}
+
+std::string TapeValue::str() const {
+    return "TapeValue(data=" + std::to_string(data()) + ", grad=" + std::to_string(grad()) + ", op='" + op() + "')";
+}
+
+TapeValue TapeValue::operator+(const TapeValue& other) const {
+    check_same_tape(other);
+    return tape_->push(Tape::OpCode::Add, data() + other.data(), index_, other.index_);
+}
+
+TapeValue TapeValue::operator-(const TapeValue& other) const {
+    check_same_tape(other);
+    return tape_->push(Tape::OpCode::Sub, data() - other.data(), index_, other.index_);
+}
+
+TapeValue TapeValue::operator*(const TapeValue& other) const {
+    check_same_tape(other);
+    return tape_->push(Tape::OpCode::Mul, data() * other.data(), index_, other.index_);
+}
+
+TapeValue TapeValue::operator/(const TapeValue& other) const {
+    check_same_tape(other);
+    if (other.data() == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    return tape_->push(Tape::OpCode::Div, data() / other.data(), index_, other.index_);
+}
+
+TapeValue TapeValue::pow(double exponent) const {
+    if (data() < 0 && std::floor(exponent) != exponent) {
+        throw std::runtime_error("Imaginary result not allowed");
+    }
+    if (data() == 0 && exponent <= 0) {
+        throw std::runtime_error("Invalid exponentiation");
+    }
+
+    const double result = std::pow(data(), exponent);
+    TapeValue constant = tape_->push(Tape::OpCode::Constant, exponent);
+    return tape_->push(Tape::OpCode::Pow, result, index_, constant.index_);
+}
+
+TapeValue TapeValue::relu() const { return tape_->push(Tape::OpCode::ReLU, std::max(data(), 0.0), index_); }
+
+std::ostream& operator<<(std::ostream& os, const TapeValue& v) { return os << v.str(); }
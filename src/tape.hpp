@@ -0,0 +1,90 @@
+#ifndef CPPGRAD_TAPE_HPP
+#define CPPGRAD_TAPE_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class TapeValue;
+
+// Wengert list engine: every op appends one record to a contiguous tape and
+// backward() is a single reverse sweep over it. No per-op heap nodes, closures or hashing.
+class Tape {
+   public:
+    enum class OpCode : std::uint8_t { Leaf, Constant, Add, Sub, Mul, Div, Pow, ReLU };
+
+    struct Record {
+        OpCode op;
+        std::uint32_t lhs;
+        std::uint32_t rhs;
+        double data;
+        double grad;
+    };
+
+   private:
+    std::vector<Record> records_;
+
+    friend class TapeValue;
+    TapeValue push(OpCode op, double data, std::uint32_t lhs = 0, std::uint32_t rhs = 0);
+
+   public:
+    Tape() = default;
+
+    // Handles refer back to their tape, so it must stay put
+    Tape(const Tape&) = delete;
+    Tape& operator=(const Tape&) = delete;
+
+    TapeValue variable(double data);
+
+    // Seeds root with grad 1 and sweeps the tape backwards from it. Intermediate grads are
+    // recomputed on every call, leaf grads accumulate like Value::backward().
+    void backward(const TapeValue& root);
+
+    void zero_grad() noexcept;
+    void clear() noexcept;  // Drops all records but keeps the capacity for the next step
+    void reserve(size_t size) { records_.reserve(size); }
+
+    size_t size() const noexcept { return records_.size(); }
+    const Record& operator[](size_t index) const { return records_[index]; }
+
+    static std::string op_name(OpCode op);
+};
+
+// Lightweight handle (tape + index) mirroring the Value API
+class TapeValue {
+   private:
+    Tape* tape_;
+    std::uint32_t index_;
+
+    TapeValue(Tape* tape, std::uint32_t index) noexcept : tape_(tape), index_(index) {}
+    friend class Tape;
+
+    Tape::Record& record() const noexcept { return tape_->records_[index_]; }
+    void check_same_tape(const TapeValue& other) const;
+
+   public:
+    // Inline accessors
+    double data() const noexcept { return record().data; }
+    double grad() const noexcept { return record().grad; }
+    std::string op() const { return Tape::op_name(record().op); }
+    std::uint32_t index() const noexcept { return index_; }
+
+    void set_data(double new_data) noexcept { record().data = new_data; }
+    void set_grad(double new_grad) noexcept { record().grad = new_grad; }
+
+    std::string str() const;
+
+    // Operations
+    TapeValue operator+(const TapeValue& other) const;
+    TapeValue operator-(const TapeValue& other) const;
+    TapeValue operator*(const TapeValue& other) const;
+    TapeValue operator/(const TapeValue& other) const;
+    TapeValue pow(double exponent) const;
+    TapeValue relu() const;
+    void backward() { tape_->backward(*this); }
+
+    friend std::ostream& operator<<(std::ostream& os, const TapeValue& v);
+};
+
+#endif  // CPPGRAD_TAPE_HPP
@@ -0,0 +1,498 @@
+#include "tensor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+size_t product(const std::vector<size_t>& shape) {
+    size_t n = 1;
+    for (size_t dim : shape) n *= dim;
+    return n;
+}
+
+std::vector<size_t> row_major_strides(const std::vector<size_t>& shape) {
+    std::vector<size_t> strides(shape.size(), 1);
+    for (size_t i = shape.size(); i-- > 1;) {
+        strides[i - 1] = strides[i] * shape[i];
+    }
+    return strides;
+}
+
+std::string shape_str(const std::vector<size_t>& shape) {
+    std::string result = "[";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        result += (i ? ", " : "") + std::to_string(shape[i]);
+    }
+    return result + "]";
+}
+
+std::vector<size_t> broadcast_shape(const std::vector<size_t>& a, const std::vector<size_t>& b) {
+    // Leading 1-dims don't change the layout; what is left of the smaller operand must be a suffix of the
+    // larger one, so that its elements repeat in blocks (for_each_broadcast)
+    auto strip = [](const std::vector<size_t>& shape) {
+        auto first = std::find_if(shape.begin(), shape.end(), [](size_t dim) { return dim != 1; });
+        return std::vector<size_t>(first, shape.end());
+    };
+    const std::vector<size_t> sa = strip(a);
+    const std::vector<size_t> sb = strip(b);
+    const auto& longer = sa.size() >= sb.size() ? sa : sb;
+    const auto& shorter = sa.size() >= sb.size() ? sb : sa;
+    if (!std::equal(shorter.rbegin(), shorter.rend(), longer.rbegin())) {
+        throw std::runtime_error("Incompatible tensor shapes " + shape_str(a) + " and " + shape_str(b));
+    }
+
+    // Dimensions aligned from the right, missing ones counting as 1
+    std::vector<size_t> shape(std::max(a.size(), b.size()), 1);
+    for (size_t i = 0; i < shape.size(); ++i) {
+        const size_t da = i < a.size() ? a[a.size() - 1 - i] : 1;
+        const size_t db = i < b.size() ? b[b.size() - 1 - i] : 1;
+        shape[shape.size() - 1 - i] = std::max(da, db);
+    }
+    return shape;
+}
+
+// Calls fn(i, ia, ib) for every output element i, with ia and ib the (possibly broadcast) operand indices.
+// Each case is a plain loop over contiguous memory so that the compiler can vectorize it.
+template <typename Fn>
+void for_each_broadcast(size_t n, size_t na, size_t nb, Fn fn) {
+    if (na == n && nb == n) {
+        for (size_t i = 0; i < n; ++i) fn(i, i, i);
+    } else if (nb == 1) {
+        for (size_t i = 0; i < n; ++i) fn(i, i, 0);
+    } else if (na == 1) {
+        for (size_t i = 0; i < n; ++i) fn(i, 0, i);
+    } else if (nb < n) {
+        for (size_t offset = 0; offset < n; offset += nb) {
+            for (size_t j = 0; j < nb; ++j) fn(offset + j, offset + j, j);
+        }
+    } else {
+        for (size_t offset = 0; offset < n; offset += na) {
+            for (size_t j = 0; j < na; ++j) fn(offset + j, j, offset + j);
+        }
+    }
+}
+
+}  // namespace
+
+Tensor::Data::Data(std::vector<size_t> shape, const std::vector<DataPtr>& children, const std::string& op)
+    : shape(std::move(shape)),
+      strides(row_major_strides(this->shape)),
+      children(children),
+      backward_fn([]() {}),
+      op(op),
+      data_storage(product(this->shape)),
+      grad_storage(data_storage.size()) {
+    data = Span<double>(data_storage.data(), data_storage.size());
+    grad = Span<double>(grad_storage.data(), grad_storage.size());
+}
+
+Tensor::Data::Data(std::vector<size_t> shape, double* data, double* grad, std::shared_ptr<void> owner)
+    : shape(std::move(shape)),
+      strides(row_major_strides(this->shape)),
+      data(data, product(this->shape)),
+      grad(grad, product(this->shape)),
+      backward_fn([]() {}),
+      storage_owner(std::move(owner)) {}
+
+Tensor::Tensor(std::vector<size_t> shape, double fill) : data_ptr(std::make_shared<Data>(std::move(shape))) {
+    std::fill(data_ptr->data.begin(), data_ptr->data.end(), fill);
+}
+
+Tensor::Tensor(std::vector<size_t> shape, const std::vector<double>& values)
+    : data_ptr(std::make_shared<Data>(std::move(shape))) {
+    if (values.size() != numel()) {
+        throw std::runtime_error("Tensor shape does not match number of values");
+    }
+    std::copy(values.begin(), values.end(), data_ptr->data.begin());
+}
+
+Tensor Tensor::view(std::vector<size_t> shape, double* data, double* grad, std::shared_ptr<void> owner) {
+    return Tensor(std::make_shared<Data>(std::move(shape), data, grad, std::move(owner)));
+}
+
+Tensor Tensor::from_values(const std::vector<Value>& values, std::vector<size_t> shape) {
+    if (shape.empty()) shape = {values.size()};
+    Tensor result = make_result(std::move(shape), {}, "stack");
+    if (values.size() != result.numel()) {
+        throw std::runtime_error("Tensor shape does not match number of values");
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        result.data()[i] = values[i].data();
+    }
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get(), values = values]() {
+        Value::backward_from(values, Span<const double>(out->grad.data(), out->grad.size()));
+    };
+
+    return result;
+}
+
+Tensor Tensor::make_result(std::vector<size_t> shape, const std::vector<DataPtr>& children, const std::string& op) {
+    return Tensor(std::make_shared<Data>(std::move(shape), children, op));
+}
+
+std::vector<Value> Tensor::values() const {
+    std::vector<Value> views;
+    views.reserve(numel());
+    for (size_t i = 0; i < numel(); ++i) {
+        views.push_back(Value::view(data_ptr->data[i], data_ptr->grad[i], data_ptr));
+    }
+    return views;
+}
+
+size_t Tensor::offset(const std::vector<size_t>& index) const {
+    if (index.size() != ndim()) {
+        throw std::runtime_error("Tensor index has wrong number of dimensions");
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < index.size(); ++i) {
+        if (index[i] >= data_ptr->shape[i]) {
+            throw std::runtime_error("Tensor index out of range");
+        }
+        offset += index[i] * data_ptr->strides[i];
+    }
+    return offset;
+}
+
+double Tensor::at(const std::vector<size_t>& index) const { return data_ptr->data[offset(index)]; }
+
+double Tensor::grad_at(const std::vector<size_t>& index) const { return data_ptr->grad[offset(index)]; }
+
+double Tensor::item() const {
+    if (numel() != 1) {
+        throw std::runtime_error("item() requires a tensor with exactly one element");
+    }
+    return data_ptr->data[0];
+}
+
+void Tensor::zero_grad() noexcept { std::fill(data_ptr->grad.begin(), data_ptr->grad.end(), 0.0); }
+
+std::string Tensor::str() const { return "Tensor(shape=" + shape_str(shape()) + ", op='" + op() + "')"; }
+
+// Backward closures capture only their own node, which owns them and keeps the operands alive (see value.cpp)
+
+Tensor Tensor::operator+(const Tensor& other) const {
+    Tensor result = make_result(broadcast_shape(shape(), other.shape()), {data_ptr, other.data_ptr}, "+");
+    const double* a = data();
+    const double* b = other.data();
+    double* out = result.data();
+    for_each_broadcast(result.numel(), numel(), other.numel(),
+                       [=](size_t i, size_t ia, size_t ib) { out[i] = a[ia] + b[ib]; });
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get()]() {
+        Data& lhs = *out->children[0];
+        Data& rhs = *out->children[1];
+        const double* g = out->grad.data();
+        double* ga = lhs.grad.data();
+        double* gb = rhs.grad.data();
+        for_each_broadcast(out->grad.size(), lhs.grad.size(), rhs.grad.size(), [=](size_t i, size_t ia, size_t ib) {
+            ga[ia] += g[i];
+            gb[ib] += g[i];
+        });
+    };
+
+    return result;
+}
+
+Tensor Tensor::operator-(const Tensor& other) const {
+    Tensor result = make_result(broadcast_shape(shape(), other.shape()), {data_ptr, other.data_ptr}, "-");
+    const double* a = data();
+    const double* b = other.data();
+    double* out = result.data();
+    for_each_broadcast(result.numel(), numel(), other.numel(),
+                       [=](size_t i, size_t ia, size_t ib) { out[i] = a[ia] - b[ib]; });
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get()]() {
+        Data& lhs = *out->children[0];
+        Data& rhs = *out->children[1];
+        const double* g = out->grad.data();
+        double* ga = lhs.grad.data();
+        double* gb = rhs.grad.data();
+        for_each_broadcast(out->grad.size(), lhs.grad.size(), rhs.grad.size(), [=](size_t i, size_t ia, size_t ib) {
+            ga[ia] += g[i];
+            gb[ib] -= g[i];
+        });
+    };
+
+    return result;
+}
+
+Tensor Tensor::operator*(const Tensor& other) const {
+    Tensor result = make_result(broadcast_shape(shape(), other.shape()), {data_ptr, other.data_ptr}, "*");
+    const double* a = data();
+    const double* b = other.data();
+    double* out = result.data();
+    for_each_broadcast(result.numel(), numel(), other.numel(),
+                       [=](size_t i, size_t ia, size_t ib) { out[i] = a[ia] * b[ib]; });
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get()]() {
+        Data& lhs = *out->children[0];
+        Data& rhs = *out->children[1];
+        const double* g = out->grad.data();
+        const double* a = lhs.data.data();
+        const double* b = rhs.data.data();
+        double* ga = lhs.grad.data();
+        double* gb = rhs.grad.data();
+        for_each_broadcast(out->grad.size(), lhs.grad.size(), rhs.grad.size(), [=](size_t i, size_t ia, size_t ib) {
+            ga[ia] += b[ib] * g[i];
+            gb[ib] += a[ia] * g[i];
+        });
+    };
+
+    return result;
+}
+
+Tensor Tensor::operator/(const Tensor& other) const {
+    if (std::find(other.data_ptr->data.begin(), other.data_ptr->data.end(), 0.0) != other.data_ptr->data.end()) {
+        throw std::runtime_error("Division by zero");
+    }
+    Tensor result = make_result(broadcast_shape(shape(), other.shape()), {data_ptr, other.data_ptr}, "/");
+    const double* a = data();
+    const double* b = other.data();
+    double* out = result.data();
+    for_each_broadcast(result.numel(), numel(), other.numel(),
+                       [=](size_t i, size_t ia, size_t ib) { out[i] = a[ia] / b[ib]; });
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get()]() {
+        Data& lhs = *out->children[0];
+        Data& rhs = *out->children[1];
+        const double* g = out->grad.data();
+        const double* a = lhs.data.data();
+        const double* b = rhs.data.data();
+        double* ga = lhs.grad.data();
+        double* gb = rhs.grad.data();
+        for_each_broadcast(out->grad.size(), lhs.grad.size(), rhs.grad.size(), [=](size_t i, size_t ia, size_t ib) {
+            ga[ia] += g[i] / b[ib];
+            gb[ib] -= g[i] * a[ia] / (b[ib] * b[ib]);
+        });
+    };
+
+    return result;
+}
+
+Tensor Tensor::pow(double exponent) const {
+    for (double x : data_ptr->data) {
+        if (x < 0 && std::floor(exponent) != exponent) {
+            throw std::runtime_error("Imaginary result not allowed");
+        }
+        if (x == 0 && exponent <= 0) {
+            throw std::runtime_error("Invalid exponentiation");
+        }
+    }
+
+    Tensor result = make_result(shape(), {data_ptr}, "pow");
+    const double* a = data();
+    double* out = result.data();
+    for (size_t i = 0; i < result.numel(); ++i) {
+        out[i] = std::pow(a[i], exponent);
+    }
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get(), exponent]() {
+        Data& base = *out->children[0];
+        for (size_t i = 0; i < out->grad.size(); ++i) {
+            base.grad[i] += exponent * std::pow(base.data[i], exponent - 1) * out->grad[i];
+        }
+    };
+
+    return result;
+}
+
+Tensor Tensor::relu() const {
+    Tensor result = make_result(shape(), {data_ptr}, "ReLU");
+    const double* a = data();
+    double* out = result.data();
+    for (size_t i = 0; i < result.numel(); ++i) {
+        out[i] = std::max(a[i], 0.0);
+    }
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get()]() {
+        Data& input = *out->children[0];
+        const double* g = out->grad.data();
+        const double* x = input.data.data();
+        double* gx = input.grad.data();
+        for (size_t i = 0; i < out->grad.size(); ++i) {
+            gx[i] += (x[i] > 0) ? g[i] : 0.0;
+        }
+    };
+
+    return result;
+}
+
+Tensor Tensor::matmul(const Tensor& other) const {
+    if (ndim() != 2 || other.ndim() != 2 || shape()[1] != other.shape()[0]) {
+        throw std::runtime_error("matmul requires tensors of shape [m, k] and [k, n]");
+    }
+    const size_t m = shape()[0];
+    const size_t k = shape()[1];
+    const size_t n = other.shape()[1];
+
+    Tensor result = make_result({m, n}, {data_ptr, other.data_ptr}, "matmul");
+    const double* a = data();
+    const double* b = other.data();
+    double* out = result.data();
+    // i-p-j order streams rows of b and out, keeping the inner loop contiguous
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t p = 0; p < k; ++p) {
+            const double a_ip = a[i * k + p];
+            for (size_t j = 0; j < n; ++j) {
+                out[i * n + j] += a_ip * b[p * n + j];
+            }
+        }
+    }
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get(), m, k, n]() {
+        Data& lhs = *out->children[0];
+        Data& rhs = *out->children[1];
+        const double* g = out->grad.data();
+        const double* a = lhs.data.data();
+        const double* b = rhs.data.data();
+        double* ga = lhs.grad.data();
+        double* gb = rhs.grad.data();
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t p = 0; p < k; ++p) {
+                // d(a) = g @ b^T: dot product of row i of g with row p of b
+                double acc = 0.0;
+                for (size_t j = 0; j < n; ++j) {
+                    acc += g[i * n + j] * b[p * n + j];
+                }
+                ga[i * k + p] += acc;
+                // d(b) = a^T @ g: row p of d(b) accumulates row i of g
+                const double a_ip = a[i * k + p];
+                for (size_t j = 0; j < n; ++j) {
+                    gb[p * n + j] += a_ip * g[i * n + j];
+                }
+            }
+        }
+    };
+
+    return result;
+}
+
+Tensor Tensor::transpose() const {
+    if (ndim() != 2) {
+        throw std::runtime_error("transpose requires a 2-D tensor");
+    }
+    const size_t rows = shape()[0];
+    const size_t cols = shape()[1];
+
+    Tensor result = make_result({cols, rows}, {data_ptr}, "transpose");
+    const double* a = data();
+    double* out = result.data();
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            out[j * rows + i] = a[i * cols + j];
+        }
+    }
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get(), rows, cols]() {
+        double* ga = out->children[0]->grad.data();
+        const double* g = out->grad.data();
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                ga[i * cols + j] += g[j * rows + i];
+            }
+        }
+    };
+
+    return result;
+}
+
+Tensor Tensor::sum() const {
+    Tensor result = make_result({}, {data_ptr}, "sum");
+    double total = 0.0;
+    for (double x : data_ptr->data) total += x;
+    result.data()[0] = total;
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get()]() {
+        const double g = out->grad[0];
+        for (double& gx : out->children[0]->grad) gx += g;
+    };
+
+    return result;
+}
+
+Tensor Tensor::sum(size_t axis) const {
+    if (axis >= ndim()) {
+        throw std::runtime_error("Reduction axis out of range");
+    }
+    std::vector<size_t> reduced = shape();
+    reduced.erase(reduced.begin() + static_cast<std::ptrdiff_t>(axis));
+    const size_t extent = shape()[axis];
+    const size_t inner = strides()[axis];
+    const size_t outer = extent * inner == 0 ? 0 : numel() / (extent * inner);
+
+    Tensor result = make_result(std::move(reduced), {data_ptr}, "sum");
+    const double* a = data();
+    double* out = result.data();
+    for (size_t o = 0; o < outer; ++o) {
+        for (size_t r = 0; r < extent; ++r) {
+            for (size_t i = 0; i < inner; ++i) {
+                out[o * inner + i] += a[(o * extent + r) * inner + i];
+            }
+        }
+    }
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get(), outer, extent, inner]() {
+        double* ga = out->children[0]->grad.data();
+        const double* g = out->grad.data();
+        for (size_t o = 0; o < outer; ++o) {
+            for (size_t r = 0; r < extent; ++r) {
+                for (size_t i = 0; i < inner; ++i) {
+                    ga[(o * extent + r) * inner + i] += g[o * inner + i];
+                }
+            }
+        }
+    };
+
+    return result;
+}
+
+Tensor Tensor::mean() const {
+    Tensor result = make_result({}, {data_ptr}, "mean");
+    const double count = static_cast<double>(numel());
+    double total = 0.0;
+    for (double x : data_ptr->data) total += x;
+    result.data()[0] = total / count;
+
+    result.data_ptr->backward_fn = [out = result.data_ptr.get(), count]() {
+        const double g = out->grad[0] / count;
+        for (double& gx : out->children[0]->grad) gx += g;
+    };
+
+    return result;
+}
+
+void Tensor::backward() {
+    static std::atomic<std::uint64_t> next_epoch{0};
+    const std::uint64_t epoch = ++next_epoch;
+
+    // Same explicit-stack post-order DFS as Value::backward()
+    std::vector<Data*> topo_order;
+    std::vector<std::pair<Data*, size_t>> stack;
+    data_ptr->visit_epoch = epoch;
+    stack.emplace_back(data_ptr.get(), 0);
+    while (!stack.empty()) {
+        auto& [node, next_child] = stack.back();
+        if (next_child < node->children.size()) {
+            Data* child = node->children[next_child++].get();
+            if (child->visit_epoch != epoch) {
+                child->visit_epoch = epoch;
+                stack.emplace_back(child, 0);
+            }
+        } else {
+            topo_order.push_back(node);
+            stack.pop_back();
+        }
+    }
+
+    std::fill(data_ptr->grad.begin(), data_ptr->grad.end(), 1.0);
+    for (auto it = topo_order.rbegin(); it != topo_order.rend(); ++it) {
+        (*it)->backward_fn();
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const Tensor& t) { return os << t.str(); }
@@ -0,0 +1,100 @@
+#ifndef CPPGRAD_TENSOR_HPP
+#define CPPGRAD_TENSOR_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "aligned_allocator.hpp"
+#include "span.hpp"
+#include "value.hpp"
+
+// N-dimensional counterpart of Value: data and grad live in contiguous, aligned row-major buffers
+// and every op records a single graph node regardless of the number of elements.
+class Tensor {
+   private:
+    struct Data;
+    using DataPtr = std::shared_ptr<Data>;
+
+    struct Data {
+        std::vector<size_t> shape;
+        std::vector<size_t> strides;
+        Span<double> data;  // Point into the storage below unless the tensor views an external buffer
+        Span<double> grad;
+        std::vector<DataPtr> children;
+        std::function<void()> backward_fn;
+        std::string op;
+        std::uint64_t visit_epoch = 0;
+        AlignedVector<double> data_storage;
+        AlignedVector<double> grad_storage;
+        std::shared_ptr<void> storage_owner;
+
+        Data(std::vector<size_t> shape, const std::vector<DataPtr>& children = {}, const std::string& op = "");
+        Data(std::vector<size_t> shape, double* data, double* grad, std::shared_ptr<void> owner);
+    };
+
+    DataPtr data_ptr;
+
+    explicit Tensor(DataPtr data_ptr) noexcept : data_ptr(std::move(data_ptr)) {}
+    static Tensor make_result(std::vector<size_t> shape, const std::vector<DataPtr>& children, const std::string& op);
+    size_t offset(const std::vector<size_t>& index) const;
+
+   public:
+    explicit Tensor(std::vector<size_t> shape, double fill = 0.0);
+    Tensor(std::vector<size_t> shape, const std::vector<double>& values);
+
+    // Leaf over external contiguous data and grad buffers (e.g. a ParameterBuffer) kept alive by `owner`
+    static Tensor view(std::vector<size_t> shape, double* data, double* grad, std::shared_ptr<void> owner);
+
+    // Packs scalar Values into a tensor (1-D unless a shape is given). On backward() gradients flow back into
+    // them and on through the Value graphs they were computed by (Value::backward_from).
+    static Tensor from_values(const std::vector<Value>& values, std::vector<size_t> shape = {});
+
+    // Inline accessors
+    const std::vector<size_t>& shape() const noexcept { return data_ptr->shape; }
+    const std::vector<size_t>& strides() const noexcept { return data_ptr->strides; }
+    size_t ndim() const noexcept { return data_ptr->shape.size(); }
+    size_t numel() const noexcept { return data_ptr->data.size(); }
+    const std::string& op() const noexcept { return data_ptr->op; }
+
+    double* data() noexcept { return data_ptr->data.data(); }
+    const double* data() const noexcept { return data_ptr->data.data(); }
+    double* grad() noexcept { return data_ptr->grad.data(); }
+    const double* grad() const noexcept { return data_ptr->grad.data(); }
+
+    // One Value per element, viewing this tensor's data and grad in place
+    std::vector<Value> values() const;
+
+    double at(const std::vector<size_t>& index) const;
+    double grad_at(const std::vector<size_t>& index) const;
+    double item() const;
+
+    void zero_grad() noexcept;
+    std::string str() const;
+
+    // Elementwise operations; the smaller operand is broadcast when, leading 1-dims aside, its shape is a suffix
+    // of the other's, e.g. [3] or [1, 3] against [2, 3]
+    Tensor operator+(const Tensor& other) const;
+    Tensor operator-(const Tensor& other) const;
+    Tensor operator*(const Tensor& other) const;
+    Tensor operator/(const Tensor& other) const;
+    Tensor pow(double exponent) const;
+    Tensor relu() const;
+
+    Tensor matmul(const Tensor& other) const;
+    Tensor transpose() const;
+
+    // Reductions
+    Tensor sum() const;
+    Tensor sum(size_t axis) const;
+    Tensor mean() const;
+
+    // Seeds every element of this tensor with grad 1, i.e. differentiates sum()
+    void backward();
+
+    friend std::ostream& operator<<(std::ostream& os, const Tensor& t);
+};
+
+#endif  // CPPGRAD_TENSOR_HPP
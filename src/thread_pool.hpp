@@ -0,0 +1,48 @@
+#ifndef CPPGRAD_THREAD_POOL_HPP
+#define CPPGRAD_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for fork-join loops. The calling thread takes part in every loop, so a
+// pool of size n spawns n - 1 threads. Tasks are handed out through an atomic counter; the mutex is
+// only taken to start and finish a loop.
+class ThreadPool {
+   private:
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    std::uint64_t generation_ = 0;
+    size_t active_ = 0;
+    bool stopping_ = false;
+
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    std::exception_ptr error_;
+
+    void worker_loop();
+    void run_tasks();
+
+   public:
+    explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const noexcept { return threads_.size() + 1; }
+
+    // Runs task(i) for every i in [0, count) and returns once all have finished. The first exception
+    // thrown by a task is rethrown here after the loop completes.
+    void parallel_for(size_t count, const std::function<void(size_t)>& task);
+};
+
+#endif  // CPPGRAD_THREAD_POOL_HPP
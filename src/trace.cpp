@@ -0,0 +1,220 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+struct Event {
+    const char* name;
+    const void* node;
+    std::uint64_t start_ns;
+    std::uint64_t duration_ns;
+    TracePhase phase;
+};
+
+// Written only by its thread; read once tracing has stopped
+struct ThreadBuffer {
+    std::vector<Event> events;
+    size_t recorded = 0;  // Total events, including those the ring has overwritten
+    size_t thread_id = 0;
+    std::uint64_t generation = 0;
+};
+
+// Buffers of the current trace. The mutex is only taken when a thread opens its first scope of a trace
+// and when a trace starts or is read.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<std::uint64_t> generation{0};
+    size_t capacity = 0;
+    std::uint64_t origin_ns = 0;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+std::shared_ptr<ThreadBuffer>& current_buffer() noexcept {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    return buffer;
+}
+
+// The calling thread's buffer for the current trace, or null if it has none
+ThreadBuffer* recording_buffer() noexcept {
+    ThreadBuffer* buffer = current_buffer().get();
+    if (buffer == nullptr || buffer->generation != registry().generation.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return buffer;
+}
+
+// Events of every thread, oldest first within each thread
+template <typename Fn>
+void for_each_event(Fn&& fn) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        const size_t capacity = buffer->events.size();
+        const size_t kept = std::min(buffer->recorded, capacity);
+        for (size_t i = buffer->recorded - kept; i < buffer->recorded; ++i) {
+            fn(*buffer, buffer->events[i % capacity]);
+        }
+    }
+}
+
+void write_escaped(std::ostream& out, const char* text) {
+    for (; *text != '\0'; ++text) {
+        if (*text == '"' || *text == '\\') out << '\\';
+        out << *text;
+    }
+}
+
+void write_event(std::ostream& out, bool& first, TracePhase phase, const char* name, size_t thread_id,
+                 std::uint64_t start_ns, std::uint64_t duration_ns) {
+    char times[96];
+    std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f", static_cast<double>(start_ns) / 1000.0,
+                  static_cast<double>(duration_ns) / 1000.0);
+    out << (first ? "\n" : ",\n") << "{\"name\":\"";
+    write_escaped(out, name);
+    out << "\",\"cat\":\"" << trace_phase_name(phase) << "\",\"ph\":\"X\"," << times
+        << ",\"pid\":1,\"tid\":" << thread_id;
+    first = false;
+}
+
+}  // namespace
+
+std::atomic<bool> trace_detail::active{false};
+
+std::uint64_t trace_detail::now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::uint64_t trace_detail::prepare_thread() noexcept {
+    if (ThreadBuffer* buffer = recording_buffer()) return buffer->generation;
+    Registry& reg = registry();
+    try {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(reg.capacity);
+        buffer->thread_id = reg.buffers.size();
+        buffer->generation = reg.generation.load(std::memory_order_relaxed);
+        reg.buffers.push_back(buffer);
+        current_buffer() = std::move(buffer);
+        return current_buffer()->generation;
+    } catch (...) {
+        return 0;  // Out of memory: this scope records nothing
+    }
+}
+
+void trace_detail::record(TracePhase phase, const char* name, const void* node, std::uint64_t start_ns,
+                          std::uint64_t end_ns, std::uint64_t generation) noexcept {
+    // The trace may have stopped or restarted since the scope opened
+    if (!active.load(std::memory_order_acquire)) return;
+    ThreadBuffer* buffer = recording_buffer();
+    if (buffer == nullptr || buffer->generation != generation || buffer->events.empty()) return;
+    buffer->events[buffer->recorded % buffer->events.size()] = {name, node, start_ns, end_ns - start_ns, phase};
+    ++buffer->recorded;
+}
+
+void start_trace(size_t events_per_thread) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.buffers.clear();
+    reg.capacity = events_per_thread;
+    reg.origin_ns = trace_detail::now_ns();
+    reg.generation.fetch_add(1, std::memory_order_release);
+    trace_detail::active.store(true, std::memory_order_release);
+}
+
+void stop_trace() noexcept { trace_detail::active.store(false, std::memory_order_release); }
+
+size_t trace_event_count() {
+    size_t count = 0;
+    for_each_event([&](const ThreadBuffer&, const Event&) { ++count; });
+    return count;
+}
+
+size_t trace_dropped_events() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t dropped = 0;
+    for (const auto& buffer : reg.buffers) {
+        dropped += buffer->recorded - std::min(buffer->recorded, buffer->events.size());
+    }
+    return dropped;
+}
+
+std::vector<TraceOpSummary> trace_summary() {
+    std::map<std::pair<TracePhase, std::string>, TraceOpSummary> totals;
+    for_each_event([&](const ThreadBuffer&, const Event& event) {
+        TraceOpSummary& summary = totals[{event.phase, event.name}];
+        summary.phase = event.phase;
+        summary.name = event.name;
+        ++summary.count;
+        summary.total_ns += event.duration_ns;
+    });
+    std::vector<TraceOpSummary> summaries;
+    for (auto& [key, summary] : totals) summaries.push_back(std::move(summary));
+    std::stable_sort(summaries.begin(), summaries.end(),
+                     [](const TraceOpSummary& a, const TraceOpSummary& b) { return a.total_ns > b.total_ns; });
+    return summaries;
+}
+
+void write_chrome_trace(std::ostream& out, size_t max_events) {
+    const size_t events = trace_event_count();
+    const std::uint64_t origin_ns = registry().origin_ns;
+    bool first = true;
+    out << "{\"traceEvents\":[";
+    if (events <= max_events) {
+        for_each_event([&](const ThreadBuffer& buffer, const Event& event) {
+            write_event(out, first, event.phase, event.name, buffer.thread_id, event.start_ns - origin_ns,
+                        event.duration_ns);
+            if (event.node != nullptr) {
+                out << ",\"args\":{\"node\":\"" << event.node << "\"}";
+            }
+            out << "}";
+        });
+    } else {
+        // Too many events to view: lay out one bar per phase and name, one row per phase, back to back
+        std::uint64_t offsets[3] = {0, 0, 0};
+        for (const TraceOpSummary& summary : trace_summary()) {
+            std::uint64_t& offset = offsets[static_cast<size_t>(summary.phase)];
+            write_event(out, first, summary.phase, summary.name.c_str(), static_cast<size_t>(summary.phase), offset,
+                        summary.total_ns);
+            out << ",\"args\":{\"count\":" << summary.count << ",\"mean_ns\":" << summary.total_ns / summary.count
+                << "}}";
+            offset += summary.total_ns;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"aggregated\":" << (events > max_events ? "true" : "false")
+        << ",\"events\":" << events << ",\"dropped\":" << trace_dropped_events() << "}}\n";
+}
+
+void write_chrome_trace(const std::string& path, size_t max_events) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open trace file " + path);
+    }
+    write_chrome_trace(out, max_events);
+}
+
+const char* trace_phase_name(TracePhase phase) noexcept {
+    switch (phase) {
+        case TracePhase::Forward:
+            return "forward";
+        case TracePhase::Backward:
+            return "backward";
+        default:
+            return "scope";
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef CPPGRAD_TRACE_HPP
+#define CPPGRAD_TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Timeline of the ops recorded in forward passes and propagated in Value::backward(), written as Chrome
+// trace-event JSON (chrome://tracing, Perfetto). Tracing is opt-in twice over: configure with
+// -DCPPGRAD_TRACE=ON (which defines CPPGRAD_TRACE=1) to compile the hooks in, then record between
+// start_trace() and stop_trace(). Without the option every hook compiles to nothing; with it but no trace
+// running, a hook costs one relaxed load. Each thread records into its own ring buffer without locking, so
+// a full buffer keeps the most recent events.
+#ifndef CPPGRAD_TRACE
+#define CPPGRAD_TRACE 0
+#endif
+
+inline constexpr bool kTraceEnabled = CPPGRAD_TRACE != 0;
+
+enum class TracePhase : std::uint8_t { Forward, Backward, Scope };
+
+// Total time per phase and event name, e.g. all backward "*" events
+struct TraceOpSummary {
+    TracePhase phase;
+    std::string name;
+    std::uint64_t count = 0;
+    std::uint64_t total_ns = 0;
+};
+
+// Discards any previous trace and starts recording, keeping up to `events_per_thread` events per thread
+void start_trace(size_t events_per_thread = size_t(1) << 16);
+void stop_trace() noexcept;
+
+// Reading the trace requires that no thread is recording, i.e. call these after stop_trace()
+size_t trace_event_count();
+size_t trace_dropped_events();
+std::vector<TraceOpSummary> trace_summary();  // Sorted by decreasing total time
+
+// Writes every event, or one aggregated event per phase and name when there are more than `max_events`
+void write_chrome_trace(std::ostream& out, size_t max_events = size_t(1) << 20);
+void write_chrome_trace(const std::string& path, size_t max_events = size_t(1) << 20);
+
+const char* trace_phase_name(TracePhase phase) noexcept;
+
+namespace trace_detail {
+extern std::atomic<bool> active;
+std::uint64_t now_ns() noexcept;
+// Allocates the calling thread's buffer for the current trace if needed and returns the trace's generation,
+// or 0 if that failed
+std::uint64_t prepare_thread() noexcept;
+// Drops the event unless trace `generation` is still running
+void record(TracePhase phase, const char* name, const void* node, std::uint64_t start_ns, std::uint64_t end_ns,
+            std::uint64_t generation) noexcept;
+}  // namespace trace_detail
+
+// Records one event spanning its lifetime. `name` must outlive the trace (a literal or an op name); a null
+// name records nothing. `node` identifies the Value node the event belongs to, if any.
+class TraceScope {
+   public:
+    TraceScope(TracePhase phase, const char* name, const void* node = nullptr) noexcept {
+        if constexpr (kTraceEnabled) {
+            if (name != nullptr && trace_detail::active.load(std::memory_order_relaxed) &&
+                (generation_ = trace_detail::prepare_thread()) != 0) {
+                phase_ = phase;
+                name_ = name;
+                node_ = node;
+                start_ns_ = trace_detail::now_ns();
+            }
+        }
+    }
+    ~TraceScope() {
+        if constexpr (kTraceEnabled) {
+            if (name_ != nullptr) {
+                trace_detail::record(phase_, name_, node_, start_ns_, trace_detail::now_ns(), generation_);
+            }
+        }
+    }
+
+    // For events that create their node
+    void set_node(const void* node) noexcept {
+        if constexpr (kTraceEnabled) node_ = node;
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+   private:
+    TracePhase phase_ = TracePhase::Scope;
+    const char* name_ = nullptr;
+    const void* node_ = nullptr;
+    std::uint64_t start_ns_ = 0;
+    std::uint64_t generation_ = 0;
+};
+
+#endif  // CPPGRAD_TRACE_HPP
@@ -1,109 +1,556 @@
 #include "value.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <iostream>
+#include <exception>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <unordered_set>
 
-Value::Value(double data, const std::vector<DataPtr> children, const std::string& op)
-    : data_ptr(std::make_shared<Data>(data, children, op)) {}
+#include "arena.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include "work_stealing_queue.hpp"
 
-std::string Value::str() const {
-    return "Value(data=" + std::to_string(data()) + ", grad=" + std::to_string(grad()) + ", op='" + op() + "')";
-}
+namespace {
 
-Value Value::operator+(const Value& other) const {
-    Value result(data_ptr->data + other.data_ptr->data, {data_ptr, other.data_ptr}, "+");
+// Set on the threads of a parallel backward, where several nodes may feed the same child at once
+thread_local bool concurrent_backward = false;
 
-    result.data_ptr->backward_fn = [result, this, other]() {
-        this->data_ptr->grad += result.data_ptr->grad;
-        other.data_ptr->grad += result.data_ptr->grad;
-    };
+template <typename Scalar, typename Delta>
+inline void accumulate_grad(Scalar& grad, Delta delta_value) {
+    const Scalar delta = static_cast<Scalar>(delta_value);
+    if (!concurrent_backward) {
+        grad += delta;
+        return;
+    }
+    Scalar expected;
+    __atomic_load(&grad, &expected, __ATOMIC_RELAXED);
+    Scalar desired = expected + delta;
+    while (!__atomic_compare_exchange(&grad, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        desired = expected + delta;
+    }
+}
 
-    return result;
+// Gradients only flow into nodes that require them
+template <typename Node, typename Delta>
+inline void accumulate_into(Node& node, Delta delta) {
+    if (node.requires_grad) accumulate_grad(node.grad(), delta);
 }
 
-Value Value::operator-(const Value& other) const {
-    Value result(data_ptr->data - other.data_ptr->data, {data_ptr, other.data_ptr}, "-");
+class ConcurrentBackwardScope {
+   public:
+    ConcurrentBackwardScope() noexcept { concurrent_backward = true; }
+    ~ConcurrentBackwardScope() { concurrent_backward = false; }
+};
 
-    result.data_ptr->backward_fn = [result, this, other]() {
-        this->data_ptr->grad += result.data_ptr->grad;
-        other.data_ptr->grad -= result.data_ptr->grad;
-    };
+}  // namespace
 
-    return result;
+thread_local bool NoGradGuard::active_ = false;
+
+template <typename T>
+std::atomic<std::uint64_t> BasicValue<T>::graph_rewrites{0};
+
+template <typename T>
+BasicValue<T>::BasicValue(Scalar data, bool requires_grad) : data_ptr(make_data(Op::Leaf, data, {}, 0)) {
+    data_ptr->requires_grad = requires_grad;
+}
+
+template <typename T>
+BasicValue<T>::ChildArray::ChildArray(size_t size, size_t num_constants) {
+    static_assert(sizeof(Header) % alignof(DataPtr) == 0, "Children must stay aligned after the header");
+    static_assert(sizeof(DataPtr) % alignof(double) == 0, "Constants must stay aligned after the children");
+    const size_t bytes = sizeof(Header) + size * sizeof(DataPtr) + num_constants * sizeof(double);
+    NoLeakScope* scope = NoLeakScope::current();
+    GraphArena* arena = scope != nullptr ? &scope->arena() : nullptr;
+    void* memory = arena != nullptr ? arena->allocate(bytes, alignof(Header)) : ::operator new(bytes);
+    Header* header = new (memory) Header{arena, size, num_constants};
+    children_ = reinterpret_cast<DataPtr*>(header + 1);
+    std::uninitialized_value_construct_n(children_, size);
+    std::uninitialized_value_construct_n(constants(), num_constants);
+}
+
+template <typename T>
+double* BasicValue<T>::ChildArray::constants() const noexcept {
+    const Header* header = reinterpret_cast<const Header*>(children_) - 1;
+    return reinterpret_cast<double*>(children_ + header->size);
 }
 
-Value Value::operator*(const Value& other) const {
-    Value result(data_ptr->data * other.data_ptr->data, {data_ptr, other.data_ptr}, "*");
+template <typename T>
+void BasicValue<T>::ChildArray::reset() noexcept {
+    if (children_ == nullptr) return;
+    Header* header = reinterpret_cast<Header*>(children_) - 1;
+    std::destroy_n(children_, header->size);
+    children_ = nullptr;
+    if (header->arena != nullptr) {
+        header->arena->deallocate(
+            header, sizeof(Header) + header->size * sizeof(DataPtr) + header->num_constants * sizeof(double));
+    } else {
+        ::operator delete(header);
+    }
+}
 
-    result.data_ptr->backward_fn = [result, this, other]() {
-        this->data_ptr->grad += other.data_ptr->data * result.data_ptr->grad;
-        other.data_ptr->grad += this->data_ptr->data * result.data_ptr->grad;
-    };
+template <typename T>
+typename BasicValue<T>::DataPtr BasicValue<T>::make_data(Op op, Scalar data, ChildArray children,
+                                                         std::uint32_t num_children) {
+    static_assert(!std::is_same_v<T, double> || sizeof(Data) <= 64, "Value nodes should fit in a cache line");
+    add_stat(num_children == 0 ? Stat::LeavesCreated : Stat::OpsRecorded);
+    add_stat(Stat::NodeBytes, sizeof(Data) + num_children * sizeof(DataPtr));
+    NoLeakScope* scope = NoLeakScope::current();
+    if (scope == nullptr) {
+        return std::make_shared<Data>(op, data, std::move(children), num_children);
+    }
+    return std::allocate_shared<Data>(ArenaAllocator<Data>(scope->arena()), op, data, std::move(children),
+                                      num_children);
+}
 
+template <typename T>
+BasicValue<T> BasicValue<T>::make_result(Op op, Scalar data, std::initializer_list<DataPtr> operands) {
+    if (NoGradGuard::active()) {
+        return BasicValue(data, false);
+    }
+    TraceScope trace(TracePhase::Forward, op_name(op).data());
+    ChildArray children(operands.size());
+    std::copy(operands.begin(), operands.end(), children.get());
+    BasicValue result(make_data(op, data, std::move(children), static_cast<std::uint32_t>(operands.size())));
+    trace.set_node(result.data_ptr.get());
     return result;
 }
 
-Value Value::operator/(const Value& other) const {
-    if (other.data_ptr->data == 0) {
-        throw std::runtime_error("Division by zero");
+template <typename T>
+BasicValue<T> BasicValue<T>::view(T& data, Scalar& grad, std::shared_ptr<void> owner) {
+    return BasicValue(std::make_shared<ViewData>(data, grad, std::move(owner)));
+}
+
+template <typename T>
+std::string BasicValue<T>::str() const {
+    return "Value(data=" + std::to_string(data()) + ", grad=" + std::to_string(grad()) + ", op='" +
+           std::string(op()) + "')";
+}
+
+template <typename T>
+std::string_view BasicValue<T>::op_name(Op op) noexcept {
+    switch (op) {
+        case Op::Add:
+            return "+";
+        case Op::Sub:
+            return "-";
+        case Op::Mul:
+            return "*";
+        case Op::Div:
+            return "/";
+        case Op::Pow:
+            return "pow";
+        case Op::ReLU:
+            return "ReLU";
+        case Op::Linear:
+            return "linear";
+        case Op::LinearReLU:
+            return "linear+ReLU";
+        case Op::Fused:
+            return "fused";
+        default:
+            return "";
     }
-    Value result(data_ptr->data / other.data_ptr->data, {data_ptr, other.data_ptr}, "/");
+}
 
-    result.data_ptr->backward_fn = [result, this, other]() {
-        this->data_ptr->grad += result.data_ptr->grad / other.data_ptr->data;
-        other.data_ptr->grad -=
-            result.data_ptr->grad * this->data_ptr->data / (other.data_ptr->data * other.data_ptr->data);
-    };
+template <typename T>
+BasicValue<T> BasicValue<T>::operator+(const BasicValue& other) const {
+    return make_result(Op::Add, data() + other.data(), {data_ptr, other.data_ptr});
+}
 
-    return result;
+template <typename T>
+BasicValue<T> BasicValue<T>::operator-(const BasicValue& other) const {
+    return make_result(Op::Sub, data() - other.data(), {data_ptr, other.data_ptr});
 }
 
-Value Value::pow(double exponent) const {
-    if (data_ptr->data < 0 && std::floor(exponent) != exponent) {
+template <typename T>
+BasicValue<T> BasicValue<T>::operator*(const BasicValue& other) const {
+    return make_result(Op::Mul, data() * other.data(), {data_ptr, other.data_ptr});
+}
+
+template <typename T>
+BasicValue<T> BasicValue<T>::operator/(const BasicValue& other) const {
+    if (other.data() == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    return make_result(Op::Div, data() / other.data(), {data_ptr, other.data_ptr});
+}
+
+template <typename T>
+BasicValue<T> BasicValue<T>::pow(double exponent) const {
+    if (data() < 0 && std::floor(exponent) != exponent) {
         throw std::runtime_error("Imaginary result not allowed");
     }
-    if (data_ptr->data == 0 && exponent <= 0) {
+    if (data() == 0 && exponent <= 0) {
         throw std::runtime_error("Invalid exponentiation");
     }
 
-    Value result(std::pow(data_ptr->data, exponent), {data_ptr}, "pow");
+    BasicValue result = make_result(Op::Pow, std::pow(data(), exponent), {data_ptr});
+    result.data_ptr->exponent = exponent;
+    return result;
+}
+
+template <typename T>
+BasicValue<T> BasicValue<T>::relu() const {
+    return make_result(Op::ReLU, std::max<Scalar>(data(), 0), {data_ptr});
+}
+
+template <typename T>
+BasicValue<T> BasicValue<T>::linear(const std::vector<BasicValue>& weights, const std::vector<BasicValue>& inputs,
+                                    bool use_relu) {
+    if (weights.size() != inputs.size() + 1) {
+        throw std::runtime_error("Expected one weight per input plus a bias");
+    }
+    const size_t n = inputs.size();
+    const Op op = use_relu ? Op::LinearReLU : Op::Linear;
+    TraceScope trace(TracePhase::Forward, NoGradGuard::active() ? nullptr : op_name(op).data());
+
+    // Same evaluation order as std::inner_product(weights, inputs, bias)
+    Scalar activation = weights[n].data();
+    for (size_t i = 0; i < n; ++i) {
+        activation = activation + weights[i].data() * inputs[i].data();
+    }
+    if (use_relu) activation = std::max<Scalar>(activation, 0);
+    if (NoGradGuard::active()) {
+        return BasicValue(activation, false);
+    }
 
-    result.data_ptr->backward_fn = [result, this, exponent]() {
-        this->data_ptr->grad += exponent * std::pow(this->data_ptr->data, exponent - 1) * result.data_ptr->grad;
-    };
+    // Children are laid out as [w_0..w_n-1, x_0..x_n-1, bias]
+    ChildArray children(2 * n + 1);
+    for (size_t i = 0; i < n; ++i) children[i] = weights[i].data_ptr;
+    for (size_t i = 0; i < n; ++i) children[n + i] = inputs[i].data_ptr;
+    children[2 * n] = weights[n].data_ptr;
 
+    BasicValue result(make_data(op, activation, std::move(children), static_cast<std::uint32_t>(2 * n + 1)));
+    trace.set_node(result.data_ptr.get());
     return result;
 }
 
-Value Value::relu() const {
-    Value result(std::max(data_ptr->data, 0.0), {data_ptr}, "ReLU");
+template <typename T>
+void BasicValue<T>::recompute(Data* out) {
+    DataPtr* children = out->children.get();
+    Scalar result{};
+    switch (out->op) {
+        case Op::Leaf:
+            return;
+        case Op::Add:
+            result = Scalar(children[0]->data()) + Scalar(children[1]->data());
+            break;
+        case Op::Sub:
+            result = Scalar(children[0]->data()) - Scalar(children[1]->data());
+            break;
+        case Op::Mul:
+            result = Scalar(children[0]->data()) * Scalar(children[1]->data());
+            break;
+        case Op::Div: {
+            const Scalar denominator = children[1]->data();
+            if (denominator == 0) {
+                throw std::runtime_error("Division by zero");
+            }
+            result = Scalar(children[0]->data()) / denominator;
+            break;
+        }
+        case Op::Pow: {
+            const Scalar base = children[0]->data();
+            const double exponent = out->exponent;
+            if (base < 0 && std::floor(exponent) != exponent) {
+                throw std::runtime_error("Imaginary result not allowed");
+            }
+            if (base == 0 && exponent <= 0) {
+                throw std::runtime_error("Invalid exponentiation");
+            }
+            result = std::pow(base, exponent);
+            break;
+        }
+        case Op::ReLU:
+            result = std::max<Scalar>(children[0]->data(), 0);
+            break;
+        case Op::Linear:
+        case Op::LinearReLU: {
+            // Same evaluation order as linear()
+            const size_t n = (out->num_children - 1) / 2;
+            result = children[2 * n]->data();
+            for (size_t i = 0; i < n; ++i) {
+                result = result + Scalar(children[i]->data()) * Scalar(children[n + i]->data());
+            }
+            if (out->op == Op::LinearReLU) result = std::max<Scalar>(result, 0);
+            break;
+        }
+        case Op::Fused:
+            result = out->fused->forward(out);
+            break;
+    }
+    out->data() = T(result);
+}
 
-    result.data_ptr->backward_fn = [result, this]() {
-        this->data_ptr->grad += (this->data_ptr->data > 0) ? result.data_ptr->grad : 0.0;
-    };
+template <typename T>
+void BasicValue<T>::propagate(Data* out) {
+    const Scalar grad = out->grad();
+    DataPtr* children = out->children.get();
+    switch (out->op) {
+        case Op::Leaf:
+            break;
+        case Op::Add:
+            accumulate_into(*children[0], grad);
+            accumulate_into(*children[1], grad);
+            break;
+        case Op::Sub:
+            accumulate_into(*children[0], grad);
+            accumulate_into(*children[1], -grad);
+            break;
+        case Op::Mul: {
+            Data& lhs = *children[0];
+            Data& rhs = *children[1];
+            accumulate_into(lhs, rhs.data() * grad);
+            accumulate_into(rhs, lhs.data() * grad);
+            break;
+        }
+        case Op::Div: {
+            Data& lhs = *children[0];
+            Data& rhs = *children[1];
+            const Scalar denominator = rhs.data();
+            accumulate_into(lhs, grad / denominator);
+            accumulate_into(rhs, -(grad * lhs.data() / (denominator * denominator)));
+            break;
+        }
+        case Op::Pow: {
+            Data& base = *children[0];
+            const double exponent = out->exponent;
+            accumulate_into(base, exponent * std::pow(Scalar(base.data()), exponent - 1) * grad);
+            break;
+        }
+        case Op::ReLU: {
+            Data& input = *children[0];
+            accumulate_into(input, (input.data() > 0) ? grad : Scalar(0));
+            break;
+        }
+        case Op::Linear:
+        case Op::LinearReLU: {
+            // Mirrors the unfused chain: products are visited last to first, then the bias
+            const Scalar upstream = (out->op == Op::Linear || out->data() > 0) ? grad : Scalar(0);
+            const size_t n = (out->num_children - 1) / 2;
+            const DataPtr* w = children;
+            const DataPtr* x = w + n;
+            for (size_t i = n; i-- > 0;) {
+                Data& weight = *w[i];
+                Data& input = *x[i];
+                accumulate_into(weight, input.data() * upstream);
+                accumulate_into(input, weight.data() * upstream);
+            }
+            accumulate_into(*children[2 * n], upstream);
+            break;
+        }
+        case Op::Fused:
+            out->fused->backward(out);
+            break;
+    }
+}
 
-    return result;
+template <typename T>
+void BasicValue<T>::accumulate(Scalar& grad, Scalar delta) noexcept {
+    accumulate_grad(grad, delta);
+}
+
+template <typename T>
+void BasicValue<T>::build_topo(Data* root, std::vector<Data*>& topo_order, bool grad_only) {
+    static std::atomic<std::uint64_t> next_epoch{0};
+    const std::uint64_t epoch = ++next_epoch;
+
+    // Explicit-stack post-order DFS, visiting children in the same order as the old recursive version. With
+    // grad_only, subgraphs that require no gradient are never entered; they hold no node that does.
+    thread_local std::vector<std::pair<Data*, size_t>> stack;
+    stack.clear();
+    root->visit_epoch = epoch;
+    stack.emplace_back(root, 0);
+    while (!stack.empty()) {
+        auto& [node, next_child] = stack.back();
+        if (next_child < node->num_children) {
+            Data* child = node->children[next_child++].get();
+            if (child->visit_epoch != epoch && (child->requires_grad || !grad_only)) {
+                child->visit_epoch = epoch;
+                stack.emplace_back(child, 0);
+            }
+        } else {
+            topo_order.push_back(node);
+            stack.pop_back();
+        }
+    }
 }
 
-void Value::backward() {
-    std::vector<DataPtr> topo_order;
-    std::unordered_set<DataPtr> visited;
-    std::function<void(const DataPtr&)> buildTopo = [&](const DataPtr& node) {
-        if (visited.find(node) != visited.end()) return;
-        visited.insert(node);
-        for (const auto& child : node->children) {
-            buildTopo(child);
+template <typename T>
+const std::vector<typename BasicValue<T>::Data*>& BasicValue<T>::topological_order(bool reuse_topology) {
+    if (reuse_topology) {
+        const std::uint64_t rewrites = graph_rewrites.load(std::memory_order_acquire);
+        if (!data_ptr->topo_order || data_ptr->topo_order->rewrites != rewrites) {
+            add_stat(Stat::TopoSorts);
+            StatTimer timer(Stat::TopoSortNs);
+            TraceScope trace(TracePhase::Backward, "topological sort");
+            auto cache = std::make_unique<TopoCache>();
+            cache->rewrites = rewrites;
+            build_topo(data_ptr.get(), cache->order);
+            data_ptr->topo_order = std::move(cache);
         }
-        topo_order.push_back(node);
-    };
+        return data_ptr->topo_order->order;
+    }
+    add_stat(Stat::TopoSorts);
+    StatTimer timer(Stat::TopoSortNs);
+    TraceScope trace(TracePhase::Backward, "topological sort");
+    thread_local std::vector<Data*> scratch;
+    scratch.clear();
+    build_topo(data_ptr.get(), scratch);
+    return scratch;
+}
 
-    buildTopo(data_ptr);
+template <typename T>
+void BasicValue<T>::backward(bool reuse_topology) {
+    TraceScope trace(TracePhase::Scope, "backward");
+    add_stat(Stat::BackwardCalls);
+    const std::vector<Data*>& topo_order = topological_order(reuse_topology);
+    add_stat(Stat::BackwardNodes, topo_order.size());
+    StatTimer timer(Stat::BackwardNs);
 
-    data_ptr->grad = 1.0;
+    data_ptr->grad() = 1.0;
     for (auto it = topo_order.rbegin(); it != topo_order.rend(); ++it) {
-        (*it)->backward_fn();
+        // Leaves have nothing to propagate and are left out of the trace
+        TraceScope trace(TracePhase::Backward, (*it)->num_children != 0 ? op_name((*it)->op).data() : nullptr, *it);
+        propagate(*it);
+    }
+}
+
+template <typename T>
+void BasicValue<T>::backward(ThreadPool& pool, bool reuse_topology) {
+    if (pool.size() == 1) {
+        backward(reuse_topology);
+        return;
+    }
+    TraceScope trace(TracePhase::Scope, "parallel backward");
+    add_stat(Stat::BackwardCalls);
+    const std::vector<Data*>& topo_order = topological_order(reuse_topology);
+    add_stat(Stat::BackwardNodes, topo_order.size());
+    StatTimer timer(Stat::BackwardNs);
+
+    // A node is ready once every edge from a consumer has been processed; duplicate children count twice.
+    // Leaves have nothing to propagate and are never scheduled.
+    size_t interior = 0;
+    for (Data* node : topo_order) {
+        node->pending_parents.store(0, std::memory_order_relaxed);
+    }
+    for (Data* node : topo_order) {
+        if (node->num_children == 0) continue;
+        ++interior;
+        for (const auto& child : node->child_span()) {
+            if (child->requires_grad) child->pending_parents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    data_ptr->grad() = 1.0;
+    if (interior == 0) return;
+    std::vector<WorkStealingQueue<Data*>> queues(pool.size());
+    queues[0].push(data_ptr.get());
+    std::atomic<size_t> remaining{interior};
+    // The first node that throws stops every worker; its exception is rethrown once they have all returned
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    pool.parallel_for(queues.size(), [&](size_t worker) {
+        ConcurrentBackwardScope scope;
+        WorkStealingQueue<Data*>& own = queues[worker];
+        while (remaining.load(std::memory_order_acquire) != 0 && !failed.load(std::memory_order_relaxed)) {
+            Data* node = nullptr;
+            if (!own.pop(node)) {
+                for (size_t k = 1; k < queues.size() && node == nullptr; ++k) {
+                    queues[(worker + k) % queues.size()].steal(node);
+                }
+                if (node == nullptr) {
+                    std::this_thread::yield();
+                    continue;
+                }
+            }
+
+            try {
+                TraceScope trace(TracePhase::Backward, op_name(node->op).data(), node);
+                propagate(node);
+            } catch (...) {
+                if (!failed.exchange(true, std::memory_order_relaxed)) error = std::current_exception();
+                return;
+            }
+            // The release/acquire pair on the counter makes every grad written into a child visible to
+            // whichever worker runs it
+            for (const auto& child : node->child_span()) {
+                if (!child->requires_grad) continue;
+                if (child->pending_parents.fetch_sub(1, std::memory_order_acq_rel) == 1 && child->num_children != 0) {
+                    own.push(child.get());
+                }
+            }
+            remaining.fetch_sub(1, std::memory_order_release);
+        }
+    });
+    if (error) std::rethrow_exception(error);
+}
+
+template <typename T>
+void BasicValue<T>::backward_from(const std::vector<BasicValue>& roots, Span<const Scalar> grads) {
+    if (grads.size() != roots.size()) {
+        throw std::runtime_error("backward_from needs one gradient per root");
+    }
+    // Post-orders of the roots concatenated, keeping the first occurrence of shared nodes, are still
+    // children first
+    std::vector<Data*> order;
+    std::vector<Data*> scratch;
+    std::unordered_set<const Data*> seen;
+    for (const BasicValue& root : roots) {
+        if (!root.data_ptr->requires_grad || seen.count(root.data_ptr.get()) != 0) continue;
+        scratch.clear();
+        build_topo(root.data_ptr.get(), scratch);
+        for (Data* node : scratch) {
+            if (seen.insert(node).second) order.push_back(node);
+        }
+    }
+
+    for (Data* node : order) {
+        if (node->num_children != 0) node->grad() = 0;
+    }
+    for (size_t i = 0; i < roots.size(); ++i) {
+        if (roots[i].data_ptr->requires_grad) accumulate(roots[i].data_ptr->grad(), grads[i]);
+    }
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        propagate(*it);
+    }
+}
+
+template <typename T>
+BasicValue<T>::Data::~Data() {
+    // Releasing a long chain recursively would overflow the stack, so the outermost destructor
+    // drains every node that dies with it from a flat list
+    thread_local std::vector<DataPtr>* releasing = nullptr;
+    if (num_children == 0) return;
+    if (releasing != nullptr) {
+        for (auto& child : child_span()) {
+            releasing->push_back(std::move(child));
+        }
+        return;
+    }
+
+    // Direct children are released in place; only their own children land in the list
+    std::vector<DataPtr> pending;
+    releasing = &pending;
+    for (auto& child : child_span()) {
+        child.reset();
+    }
+    while (!pending.empty()) {
+        DataPtr node = std::move(pending.back());
+        pending.pop_back();
+        node.reset();
     }
+    releasing = nullptr;
 }
 
-std::ostream& operator<<(std::ostream& os, const Value& v) { return os << v.str(); }
+template class BasicValue<double>;
+template class BasicValue<float>;
+template class BasicValue<BFloat16>;
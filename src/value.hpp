@@ -1,57 +1,264 @@
 #ifndef CPPGRAD_VALUE_HPP
 #define CPPGRAD_VALUE_HPP
 
-#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
 #include <memory>
+#include <ostream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-class Value {
+#include "bfloat16.hpp"
+#include "span.hpp"
+
+class GraphArena;
+class ThreadPool;
+
+template <typename T>
+struct FusedAccess;
+
+template <typename T>
+class BasicGraphPlan;
+
+template <typename T>
+class BasicGraphFile;
+
+// Type that a scalar of storage type T is computed and its gradient accumulated in
+template <typename T>
+struct ScalarTraits {
+    using compute_type = T;
+};
+
+template <>
+struct ScalarTraits<BFloat16> {
+    using compute_type = float;
+};
+
+// Scalar autograd node with data stored as T. Arithmetic and gradients use ScalarTraits<T>::compute_type,
+// so a BFloat16 value halves the storage of its data while still accumulating gradients in float.
+template <typename T>
+class BasicValue {
+   public:
+    using Scalar = typename ScalarTraits<T>::compute_type;
+
+    enum class Op : std::uint8_t { Leaf, Add, Sub, Mul, Div, Pow, ReLU, Linear, LinearReLU, Fused };
+
    private:
     struct Data;
     using DataPtr = std::shared_ptr<Data>;
 
+    // Forward and backward of an Op::Fused node, generated from the expression type (expression.hpp)
+    struct FusedKernel {
+        Scalar (*forward)(Data* node);
+        void (*backward)(Data* node);
+        std::uint32_t num_constants;  // Exponents stored after the node's children, see ChildArray::constants()
+    };
+
+    // Owning array of a node's children, optionally followed by constants of the node's op. Inside a
+    // NoLeakScope it is carved from the scope's arena like the node itself, otherwise it comes from the heap; a
+    // header in front records which, and the lengths.
+    class ChildArray {
+       private:
+        struct Header {
+            GraphArena* arena;  // Null for the heap
+            size_t size;
+            size_t num_constants;
+        };
+        DataPtr* children_ = nullptr;
+
+       public:
+        ChildArray() noexcept = default;
+        explicit ChildArray(size_t size, size_t num_constants = 0);  // `size` null children, zero constants
+        ~ChildArray() { reset(); }
+        ChildArray(ChildArray&& other) noexcept : children_(std::exchange(other.children_, nullptr)) {}
+        ChildArray& operator=(ChildArray&& other) noexcept {
+            if (this != &other) {
+                reset();
+                children_ = std::exchange(other.children_, nullptr);
+            }
+            return *this;
+        }
+
+        DataPtr* get() const noexcept { return children_; }
+        DataPtr& operator[](size_t index) const noexcept { return children_[index]; }
+        double* constants() const noexcept;
+        void reset() noexcept;
+    };
+
+    // A topological order and the value of graph_rewrites it was computed at
+    struct TopoCache {
+        std::vector<Data*> order;
+        std::uint64_t rewrites;
+    };
+
+    // Graph node: plain fields and an opcode, no per-node closure or string, 64 bytes for double. Data and
+    // grad live inline, except in views, which point into an external buffer.
     struct Data {
-        double data;
-        double grad;
-        std::vector<DataPtr> children;
-        std::function<void()> backward_fn;
-        std::string op;
-
-        explicit Data(double data, const std::vector<DataPtr>& children = {}, const std::string& op = "")
-            : data(data), grad(0.0), children(children), backward_fn([]() {}), op(op) {}
+        struct Local {
+            T data;
+            Scalar grad;
+        };
+        struct External {
+            T* data;
+            Scalar* grad;
+        };
+        union Storage {
+            Local local;
+            External external;
+
+            explicit Storage(Scalar data) noexcept : local{T(data), Scalar(0)} {}
+            Storage(T* data, Scalar* grad) noexcept : external{data, grad} {}
+        } storage;
+
+        ChildArray children;
+        std::unique_ptr<TopoCache> topo_order;  // Cached by backward(true)
+        union {
+            double exponent = 0.0;     // Op::Pow
+            const FusedKernel* fused;  // Op::Fused
+        };
+        std::uint64_t visit_epoch = 0;
+        std::atomic<std::uint32_t> pending_parents{0};  // Scheduling state of a parallel backward
+        std::uint32_t num_children = 0;
+        Op op = Op::Leaf;
+        bool is_view = false;
+        bool requires_grad = true;  // Leaves choose; an op result requires grad if any of its children does
+
+        Data(Op op, Scalar data, ChildArray children, std::uint32_t num_children) noexcept
+            : storage(data),
+              children(std::move(children)),
+              num_children(num_children),
+              op(op),
+              requires_grad(num_children == 0 || any_child_requires_grad()) {}
+        Data(T& data, Scalar& grad) noexcept : storage(&data, &grad), is_view(true) {}
+        ~Data();
+
+        T& data() noexcept { return is_view ? *storage.external.data : storage.local.data; }
+        Scalar& grad() noexcept { return is_view ? *storage.external.grad : storage.local.grad; }
+        Span<DataPtr> child_span() const noexcept { return Span<DataPtr>(children.get(), num_children); }
+        bool any_child_requires_grad() const noexcept {
+            for (std::uint32_t i = 0; i < num_children; ++i) {
+                if (children[i]->requires_grad) return true;
+            }
+            return false;
+        }
+    };
+
+    // Views additionally keep the owner of their external buffer alive
+    struct ViewData : Data {
+        std::shared_ptr<void> owner;
+
+        ViewData(T& data, Scalar& grad, std::shared_ptr<void> owner) noexcept
+            : Data(data, grad), owner(std::move(owner)) {}
     };
 
     DataPtr data_ptr;
 
+    // Count of in-place graph rewrites (BasicGraphPlan::optimize); they make every cached order stale
+    static std::atomic<std::uint64_t> graph_rewrites;
+
+    static DataPtr make_data(Op op, Scalar data, ChildArray children, std::uint32_t num_children);
+    static BasicValue make_result(Op op, Scalar data, std::initializer_list<DataPtr> children);
+    static void recompute(Data* node);
+    static void propagate(Data* node);
+    static void accumulate(Scalar& grad, Scalar delta) noexcept;
+    static void build_topo(Data* root, std::vector<Data*>& topo_order, bool grad_only = true);
+    const std::vector<Data*>& topological_order(bool reuse_topology);
+
+    explicit BasicValue(DataPtr data_ptr) noexcept : data_ptr(std::move(data_ptr)) {}
+
+    friend struct FusedAccess<T>;
+    friend class BasicGraphPlan<T>;
+    friend class BasicGraphFile<T>;
+
    public:
-    explicit Value(double data, const std::vector<DataPtr> children = {}, const std::string& op = "");
-    Value(const Value&) = default;
-    Value(Value&& other) noexcept = default;
+    // Inputs, labels and constants can opt out of gradients; backward() then skips every subgraph that
+    // reaches no leaf requiring them
+    explicit BasicValue(Scalar data, bool requires_grad = true);
+
+    // Leaf whose data and grad live in an external buffer (e.g. a parameter tensor) kept alive by `owner`.
+    // Views are parameters and require grad.
+    static BasicValue view(T& data, Scalar& grad, std::shared_ptr<void> owner);
+    BasicValue(const BasicValue&) = default;
+    BasicValue(BasicValue&& other) noexcept = default;
 
-    Value& operator=(const Value&) = default;
-    Value& operator=(Value&& other) noexcept = default;
+    BasicValue& operator=(const BasicValue&) = default;
+    BasicValue& operator=(BasicValue&& other) noexcept = default;
 
     // Inline accessors
-    double data() const noexcept { return data_ptr->data; }
-    double grad() const noexcept { return data_ptr->grad; }
-    std::string op() const noexcept { return data_ptr->op; }
+    Scalar data() const noexcept { return data_ptr->data(); }
+    Scalar grad() const noexcept { return data_ptr->grad(); }
+    Op opcode() const noexcept { return data_ptr->op; }
+    bool requires_grad() const noexcept { return data_ptr->requires_grad; }
+    std::string_view op() const noexcept { return op_name(data_ptr->op); }
+
+    void set_data(Scalar new_data) noexcept { data_ptr->data() = new_data; }
+    void set_grad(Scalar new_grad) noexcept { data_ptr->grad() = new_grad; }
 
-    void set_data(double new_data) noexcept { data_ptr->data = new_data; }
-    void set_grad(double new_grad) noexcept { data_ptr->grad = new_grad; }
+    // Only affects ops recorded afterwards
+    void set_requires_grad(bool requires_grad) noexcept { data_ptr->requires_grad = requires_grad; }
 
     std::string str() const;
+    static std::string_view op_name(Op op) noexcept;
 
     // Operations
-    Value operator+(const Value& other) const;
-    Value operator-(const Value& other) const;
-    Value operator*(const Value& other) const;
-    Value operator/(const Value& other) const;
-    Value pow(double exponent) const;
-    Value relu() const;
-    void backward();
-
-    friend std::ostream& operator<<(std::ostream& os, const Value& v);
+    BasicValue operator+(const BasicValue& other) const;
+    BasicValue operator-(const BasicValue& other) const;
+    BasicValue operator*(const BasicValue& other) const;
+    BasicValue operator/(const BasicValue& other) const;
+    BasicValue pow(double exponent) const;
+    BasicValue relu() const;
+
+    // Fused neuron: relu?(bias + sum_i weights[i] * inputs[i]) recorded as a single node, with the bias
+    // stored last in `weights`. Forward and gradients are bit-identical to the equivalent chain of ops
+    // whenever T is its own compute type; for BFloat16 the sum is kept in float instead of being rounded
+    // after every step.
+    static BasicValue linear(const std::vector<BasicValue>& weights, const std::vector<BasicValue>& inputs,
+                             bool use_relu = false);
+
+    // A node's subgraph never changes, so with reuse_topology the order is computed once and kept on the root
+    void backward(bool reuse_topology = false);
+
+    // Same gradients as backward() up to floating-point reassociation, but a node runs as soon as all of
+    // its consumers have, so independent subgraphs (e.g. the neurons of a layer) are processed concurrently
+    // by the workers of `pool`. If a node throws, every worker stops and the exception is rethrown here.
+    void backward(ThreadPool& pool, bool reuse_topology = false);
+
+    // Backpropagates `grads[i]` from each of `roots` at once, as for outputs that feed a larger computation
+    // (e.g. Tensor::from_values): interior gradients below the roots restart from zero, leaf gradients
+    // accumulate, and roots that require no gradient are skipped
+    static void backward_from(const std::vector<BasicValue>& roots, Span<const Scalar> grads);
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicValue& v) { return os << v.str(); }
+};
+
+// Inference mode: while a guard is alive on this thread, Value ops compute only their forward result and
+// return plain leaves, with no children or opcode recorded for backward(). Guards nest.
+class NoGradGuard {
+   private:
+    bool previous_;
+
+    static thread_local bool active_;
+
+   public:
+    NoGradGuard() noexcept : previous_(active_) { active_ = true; }
+    ~NoGradGuard() { active_ = previous_; }
+
+    NoGradGuard(const NoGradGuard&) = delete;
+    NoGradGuard& operator=(const NoGradGuard&) = delete;
+
+    static bool active() noexcept { return active_; }
 };
 
-#endif  // CPPGRAD_VALUE_HPP
\ No newline at end of file
+// Defined in value.cpp for these types only
+extern template class BasicValue<double>;
+extern template class BasicValue<float>;
+extern template class BasicValue<BFloat16>;
+
+using Value = BasicValue<double>;
+using FloatValue = BasicValue<float>;
+using BFloat16Value = BasicValue<BFloat16>;
+
+#endif  // CPPGRAD_VALUE_HPP
@@ -0,0 +1,38 @@
+#ifndef CPPGRAD_WORK_STEALING_QUEUE_HPP
+#define CPPGRAD_WORK_STEALING_QUEUE_HPP
+
+#include <deque>
+#include <mutex>
+
+// Per-worker task queue: the owner pushes and pops at the back (LIFO, cache-warm), idle workers steal
+// from the front. Each queue has its own lock, so contention only arises when a thief hits a busy owner.
+template <typename T>
+class WorkStealingQueue {
+   private:
+    std::deque<T> tasks_;
+    std::mutex mutex_;
+
+   public:
+    void push(T task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+
+    bool pop(T& task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) return false;
+        task = std::move(tasks_.back());
+        tasks_.pop_back();
+        return true;
+    }
+
+    bool steal(T& task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) return false;
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+        return true;
+    }
+};
+
+#endif  // CPPGRAD_WORK_STEALING_QUEUE_HPP
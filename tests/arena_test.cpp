@@ -0,0 +1,153 @@
+#include "arena.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "neuron.hpp"
+#include "value.hpp"
+
+TEST_CASE("Arena allocations are aligned", "[arena]") {
+    GraphArena arena(256);
+    for (size_t alignment : {1, 8, 16, 64}) {
+        void* p = arena.allocate(24, alignment);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(p) % alignment == 0);
+    }
+    REQUIRE(arena.live_allocations() == 4);
+    REQUIRE_FALSE(arena.reset());
+}
+
+TEST_CASE("Arena grows past its block size", "[arena]") {
+    GraphArena arena(64);
+    void* big = arena.allocate(1024, 8);
+    REQUIRE(big != nullptr);
+    REQUIRE(arena.bytes_reserved() >= 1024);
+    arena.deallocate(big, 1024);
+    REQUIRE(arena.reset());
+    REQUIRE(arena.bytes_used() == 0);
+}
+
+TEST_CASE("Gradients inside a NoLeakScope", "[arena]") {
+    GraphArena arena;
+    Value a(2.0);
+    Value b(3.0);
+    {
+        NoLeakScope scope(arena);
+        Value c = a * b + a.pow(2.0);
+        c.backward();
+        REQUIRE(arena.live_allocations() > 0);
+    }
+    REQUIRE(std::abs(a.grad() - 7.0) < 1e-6);  // b + 2a
+    REQUIRE(std::abs(b.grad() - 2.0) < 1e-6);
+    REQUIRE(arena.live_allocations() == 0);
+    REQUIRE(arena.bytes_used() == 0);
+}
+
+TEST_CASE("Node children are allocated from the arena", "[arena]") {
+    GraphArena arena;
+    Value a(2.0);
+    NoLeakScope scope(arena);
+    Value b = a * a;
+    REQUIRE(arena.live_allocations() == 2);  // The node and its children
+}
+
+TEST_CASE("NoLeakScope recycles the arena every step", "[arena]") {
+    GraphArena arena;
+    Neuron n(16);
+    size_t reserved = 0;
+    for (int step = 0; step < 10; ++step) {
+        NoLeakScope scope(arena);
+        std::vector<Value> inputs;
+        for (int i = 0; i < 16; ++i) inputs.emplace_back(0.1 * i);
+        Value out = n(inputs);
+        out.backward();
+        if (step == 1) reserved = arena.bytes_reserved();
+        if (step > 1) REQUIRE(arena.bytes_reserved() == reserved);
+    }
+    REQUIRE(arena.live_allocations() == 0);
+}
+
+TEST_CASE("Parameters created inside a NoLeakScope are persistent", "[arena]") {
+    GraphArena arena;
+    std::vector<Value> params;
+    {
+        NoLeakScope scope(arena);
+        Neuron n(4);
+        params = n.parameters();
+    }
+    REQUIRE(arena.live_allocations() == 0);
+    REQUIRE(params.size() == 5);
+}
+
+TEST_CASE("Intermediate nodes are freed as soon as the root is dropped", "[arena]") {
+    GraphArena arena;
+    NoLeakScope scope(arena);
+    Value a(2.0);
+    {
+        Value b = (a * a + a).relu().pow(2.0) / a;
+        b.backward();
+        REQUIRE(arena.live_allocations() == 11);  // 6 nodes and the children arrays of 5
+    }
+    REQUIRE(arena.live_allocations() == 1);
+}
+
+TEST_CASE("Values escaping a NoLeakScope keep their graph", "[arena]") {
+    GraphArena arena;
+    Value a(2.0);
+    Value escaped(0.0);
+    {
+        NoLeakScope scope(arena);
+        escaped = a * a;
+    }
+    REQUIRE(std::abs(escaped.data() - 4.0) < 1e-6);
+    REQUIRE(arena.live_allocations() == 2);  // The node and its children array
+    escaped.backward();
+    REQUIRE(std::abs(a.grad() - 4.0) < 1e-6);
+    REQUIRE(arena.bytes_used() > 0);  // not rewound while a node is alive
+    escaped = Value(0.0);
+    REQUIRE(arena.live_allocations() == 0);
+}
+
+TEST_CASE("Arena nodes can be released on other threads", "[arena]") {
+    GraphArena arena;
+    Value a(2.0);
+    std::vector<Value> products;
+    {
+        NoLeakScope scope(arena);
+        for (int i = 0; i < 64; ++i) products.push_back(a * a);
+    }
+    REQUIRE(arena.live_allocations() == 128);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        std::vector<Value> share(products.begin() + static_cast<std::ptrdiff_t>(16 * t),
+                                 products.begin() + static_cast<std::ptrdiff_t>(16 * (t + 1)));
+        threads.emplace_back([share = std::move(share)]() mutable { share.clear(); });
+    }
+    products.clear();
+    for (std::thread& thread : threads) thread.join();
+    REQUIRE(arena.live_allocations() == 0);
+    REQUIRE(arena.reset());
+}
+
+TEST_CASE("Nested NoLeakScopes restore the outer arena", "[arena]") {
+    GraphArena outer_arena;
+    GraphArena inner_arena;
+    NoLeakScope outer(outer_arena);
+    REQUIRE(NoLeakScope::current() == &outer);
+    {
+        NoLeakScope inner(inner_arena);
+        REQUIRE(NoLeakScope::current() == &inner);
+        Value v(1.0);
+        REQUIRE(inner_arena.live_allocations() == 1);
+        REQUIRE(outer_arena.live_allocations() == 0);
+    }
+    REQUIRE(NoLeakScope::current() == &outer);
+    {
+        PersistentScope persistent;
+        REQUIRE(NoLeakScope::current() == nullptr);
+    }
+    REQUIRE(NoLeakScope::current() == &outer);
+}
@@ -0,0 +1,35 @@
+#include "bfloat16.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <limits>
+
+#include "value.hpp"
+
+TEST_CASE("BFloat16 keeps the upper half of a float", "[bfloat16]") {
+    REQUIRE(BFloat16(1.0f).bits() == 0x3f80);
+    REQUIRE(BFloat16(-2.0f).bits() == 0xc000);
+    REQUIRE(float(BFloat16(0.15625f)) == 0.15625f);
+    REQUIRE(sizeof(BFloat16) == 2);
+}
+
+TEST_CASE("BFloat16 rounds to nearest even", "[bfloat16]") {
+    // 1 + 2^-8 lies halfway between 1 and 1 + 2^-7: ties go to the even mantissa
+    REQUIRE(float(BFloat16(1.0f + std::ldexp(1.0f, -8))) == 1.0f);
+    REQUIRE(float(BFloat16(1.0f + 3 * std::ldexp(1.0f, -8))) == 1.0f + std::ldexp(1.0f, -6));
+    REQUIRE(float(BFloat16(1.0f + std::ldexp(1.0f, -8) + std::ldexp(1.0f, -12))) == 1.0f + std::ldexp(1.0f, -7));
+    REQUIRE(std::isinf(float(BFloat16(std::numeric_limits<float>::max()))));
+    REQUIRE(std::isnan(float(BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST_CASE("BFloat16 values accumulate gradients in float", "[bfloat16]") {
+    BFloat16Value x(1.0);
+    BFloat16Value sum(0.0);
+    for (int i = 0; i < 1001; ++i) {
+        sum = sum + x;
+    }
+    sum.backward();
+    // A bfloat16 accumulator would stall at 256, where adding 1 falls below its resolution
+    REQUIRE(x.grad() == 1001.0f);
+    REQUIRE(float(BFloat16(x.grad())) != 1001.0f);
+}
@@ -0,0 +1,149 @@
+#include "checkpoint.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "layer.hpp"
+#include "mlp.hpp"
+#include "neuron.hpp"
+#include "optimizer.hpp"
+#include "tensor.hpp"
+
+namespace {
+
+std::string temp_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("cppgrad_" + name)).string();
+}
+
+std::vector<double> snapshot(Module& module) {
+    Span<double> data = module.data_buffer();
+    return std::vector<double>(data.begin(), data.end());
+}
+
+}  // namespace
+
+TEST_CASE("Checkpoints map large parameter buffers in place", "[checkpoint]") {
+    const std::string path = temp_path("mlp.ckpt");
+    MLP saved(64, {128, 10});  // 9610 parameters, enough for page storage
+    Checkpoint::save(saved, path);
+
+    MLP loaded(64, {128, 10});
+    Value first = loaded.parameters()[0];
+    double* storage = loaded.data_buffer().data();
+    REQUIRE(Checkpoint::load(loaded, path));
+    REQUIRE(snapshot(loaded) == snapshot(saved));
+    REQUIRE(loaded.data_buffer().data() == storage);
+    REQUIRE(first.data() == saved.parameters()[0].data());
+
+    Tensor x({1, 64}, std::vector<double>(64, 0.5));
+    Tensor expected = saved(x);
+    Tensor out = loaded(x);
+    for (size_t i = 0; i < out.numel(); ++i) REQUIRE(out.data()[i] == expected.data()[i]);
+
+    // Training the loaded model touches only its private copy of the pages
+    out.sum().backward();
+    SGD optimizer(loaded, 0.1);
+    optimizer.step();
+    REQUIRE(snapshot(loaded) != snapshot(saved));
+    MLP reloaded(64, {128, 10});
+    Checkpoint::load(reloaded, path);
+    REQUIRE(snapshot(reloaded) == snapshot(saved));
+
+    // Loading again over trained pages restores them
+    Checkpoint::load(loaded, path);
+    REQUIRE(snapshot(loaded) == snapshot(saved));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Saving a checkpoint leaves nothing else in its directory", "[checkpoint]") {
+    const std::filesystem::path directory = temp_path("checkpoint_dir");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+    const std::string path = (directory / "neuron.ckpt").string();
+    Neuron saved(8);
+    Checkpoint::save(saved, path);
+    Checkpoint::save(saved, path);  // Over an existing checkpoint
+
+    size_t entries = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        REQUIRE(entry.path().filename() == "neuron.ckpt");
+        ++entries;
+    }
+    REQUIRE(entries == 1);
+    REQUIRE((std::filesystem::status(path).permissions() & std::filesystem::perms::others_read) !=
+            std::filesystem::perms::none);
+
+    Neuron loaded(8);
+    Checkpoint::load(loaded, path);
+    REQUIRE(snapshot(loaded) == snapshot(saved));
+    std::filesystem::remove_all(directory);
+}
+
+TEMPLATE_TEST_CASE("Checkpoints round-trip neurons of every precision", "[checkpoint]", double, float, BFloat16) {
+    const std::string path = temp_path("neuron.ckpt");
+    BasicNeuron<TestType> saved(5);
+    BasicCheckpoint<TestType>::save(saved, path);
+
+    BasicNeuron<TestType> loaded(5);
+    REQUIRE_FALSE(BasicCheckpoint<TestType>::load(loaded, path));  // Too small to map
+    std::vector<BasicValue<TestType>> saved_params = saved.parameters();
+    std::vector<BasicValue<TestType>> loaded_params = loaded.parameters();
+    for (size_t i = 0; i < saved_params.size(); ++i) {
+        REQUIRE(loaded_params[i].data() == saved_params[i].data());
+        REQUIRE(loaded_params[i].grad() == 0);
+    }
+    REQUIRE_THROWS_AS(BasicCheckpoint<TestType>::load(*std::make_unique<BasicNeuron<TestType>>(4), path),
+                      std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Layers load into their range of a shared buffer", "[checkpoint]") {
+    const std::string path = temp_path("layer.ckpt");
+    Layer saved(4, 2);
+    Checkpoint::save(saved, path);
+
+    MLP mlp(3, {4, 2});
+    const std::vector<double> first = snapshot(mlp.layers()[0]);
+    Layer& second = mlp.layers()[1];
+    REQUIRE_FALSE(Checkpoint::load(second, path));
+    REQUIRE(snapshot(second) == snapshot(saved));
+    REQUIRE(snapshot(mlp.layers()[0]) == first);
+
+    Layer transposed(2, 4);  // Same parameter count, different shapes
+    REQUIRE_THROWS_AS(Checkpoint::load(transposed, path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Checkpoints reject corrupt and mismatched files", "[checkpoint]") {
+    const std::string path = temp_path("corrupt.ckpt");
+    Neuron saved(3);
+    Checkpoint::save(saved, path);
+
+    Neuron loaded(3);
+    REQUIRE_THROWS_AS(BasicCheckpoint<float>::load(*std::make_unique<FloatNeuron>(3), path), std::runtime_error);
+    REQUIRE_THROWS_AS(Checkpoint::load(loaded, temp_path("missing.ckpt")), std::runtime_error);
+
+    // Overwrite a byte of the first weight, the fourth value from the end
+    const auto size = static_cast<std::streamoff>(std::filesystem::file_size(path));
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(size - 4 * static_cast<std::streamoff>(sizeof(double)));
+        file.put('\x7f');
+    }
+    const std::vector<double> before = snapshot(loaded);
+    REQUIRE_THROWS_AS(Checkpoint::load(loaded, path), std::runtime_error);
+    REQUIRE(snapshot(loaded) == before);
+    Checkpoint::load(loaded, path, false);  // Unverified loads skip the checksum
+    REQUIRE(snapshot(loaded) != before);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    REQUIRE_THROWS_AS(Checkpoint::load(loaded, path, false), std::runtime_error);
+    std::remove(path.c_str());
+}
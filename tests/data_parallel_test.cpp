@@ -0,0 +1,97 @@
+#include "data_parallel.hpp"
+
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "mlp.hpp"
+#include "tensor.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+Tensor rows(const std::vector<double>& values, size_t width, size_t begin, size_t end) {
+    return Tensor({end - begin, width}, std::vector<double>(values.begin() + static_cast<std::ptrdiff_t>(begin * width),
+                                                            values.begin() + static_cast<std::ptrdiff_t>(end * width)));
+}
+
+struct Dataset {
+    static constexpr size_t batch = 37;
+    std::vector<double> x;
+    std::vector<double> y;
+
+    Dataset() {
+        for (size_t i = 0; i < batch; ++i) {
+            x.push_back(std::sin(0.3 * static_cast<double>(i)));
+            x.push_back(std::cos(0.7 * static_cast<double>(i)));
+            y.push_back(0.01 * static_cast<double>(i));
+        }
+    }
+
+    Tensor loss(const MLP& model, size_t begin, size_t end) const {
+        Tensor error = model(rows(x, 2, begin, end)) - rows(y, 1, begin, end);
+        return error.pow(2.0).sum() * Tensor(std::vector<size_t>{}, 1.0 / batch);
+    }
+};
+
+}  // namespace
+
+TEST_CASE("ThreadPool runs every index exactly once", "[parallel]") {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallel_for(hits.size(), [&](size_t i) { hits[i].fetch_add(1); });
+    for (auto& hit : hits) {
+        REQUIRE(hit.load() == 1);
+    }
+    REQUIRE_THROWS_AS(pool.parallel_for(8, [](size_t i) { if (i == 5) throw std::runtime_error("task"); }),
+                      std::runtime_error);
+}
+
+TEST_CASE("Replica shares data but not gradients", "[parallel]") {
+    MLP model(2, {3, 1});
+    MLP replica = model.replica();
+    REQUIRE(replica.data_buffer().data() == model.data_buffer().data());
+    REQUIRE(replica.grad_buffer().data() != model.grad_buffer().data());
+
+    Dataset data;
+    data.loss(replica, 0, Dataset::batch).backward();
+    for (double g : model.grad_buffer()) {
+        REQUIRE(g == 0.0);
+    }
+}
+
+TEST_CASE("Data-parallel gradients match a single full-batch pass", "[parallel]") {
+    MLP model(2, {8, 1});
+    Dataset data;
+
+    data.loss(model, 0, Dataset::batch).backward();
+    std::vector<double> expected(model.grad_buffer().begin(), model.grad_buffer().end());
+    model.zero_grad();
+
+    DataParallelTrainer trainer(model, 4);
+    REQUIRE(trainer.num_workers() == 4);
+    trainer.accumulate_gradients(Dataset::batch,
+                                 [&](const MLP& m, size_t begin, size_t end) { return data.loss(m, begin, end); });
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(std::abs(model.grad_buffer()[i] - expected[i]) < 1e-12);
+    }
+}
+
+TEST_CASE("Data-parallel reduction is reproducible", "[parallel]") {
+    MLP model(2, {16, 16, 1});
+    Dataset data;
+    DataParallelTrainer trainer(model, 3);
+    auto loss_fn = [&](const MLP& m, size_t begin, size_t end) { return data.loss(m, begin, end); };
+
+    double first_loss = trainer.accumulate_gradients(Dataset::batch, loss_fn);
+    std::vector<double> first(model.grad_buffer().begin(), model.grad_buffer().end());
+    for (int run = 0; run < 5; ++run) {
+        model.zero_grad();
+        REQUIRE(trainer.accumulate_gradients(Dataset::batch, loss_fn) == first_loss);
+        for (size_t i = 0; i < first.size(); ++i) {
+            REQUIRE(model.grad_buffer()[i] == first[i]);
+        }
+    }
+}
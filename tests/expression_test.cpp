@@ -0,0 +1,126 @@
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "arena.hpp"
+#include "bfloat16.hpp"
+#include "expression.hpp"
+#include "thread_pool.hpp"
+#include "value.hpp"
+
+namespace {
+
+template <typename T>
+std::vector<BasicValue<T>> make_leaves(const std::vector<double>& data) {
+    std::vector<BasicValue<T>> leaves;
+    for (double x : data) {
+        leaves.emplace_back(x);
+        leaves.back().set_grad(0.1);  // Accumulation order only shows on top of an existing gradient
+    }
+    return leaves;
+}
+
+// Evaluates `f` once with plain Value operators and once through lazy(), then backpropagates both
+template <typename T, typename F>
+void require_identical_to_per_op(const std::vector<double>& data, F f) {
+    using Value = BasicValue<T>;
+    std::vector<Value> per_op_leaves = make_leaves<T>(data);
+    std::vector<Value> fused_leaves = make_leaves<T>(data);
+
+    Value per_op = f(per_op_leaves[0], per_op_leaves[1], per_op_leaves[2]);
+    Value fused = f(lazy(fused_leaves[0]), fused_leaves[1], fused_leaves[2]);
+    REQUIRE(fused.opcode() == Value::Op::Fused);
+    REQUIRE(fused.data() == per_op.data());
+
+    per_op.backward();
+    fused.backward();
+    for (size_t i = 0; i < data.size(); ++i) {
+        REQUIRE(fused_leaves[i].grad() == per_op_leaves[i].grad());
+    }
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Fused expressions match the per-op graph exactly", "[expression]", double, float, BFloat16) {
+    const std::vector<double> data = {0.7, -1.3, 2.9};
+
+    require_identical_to_per_op<TestType>(data, [](auto a, auto b, auto c) { return a * b + c * a - b; });
+    require_identical_to_per_op<TestType>(data, [](auto a, auto b, auto c) { return (a - b).pow(2.0) / c; });
+    require_identical_to_per_op<TestType>(data, [](auto a, auto b, auto c) { return (a * a * b - c).relu() + c; });
+    require_identical_to_per_op<TestType>(data, [](auto a, auto b, auto c) { return (b * c).relu() * a + a / a; });
+    require_identical_to_per_op<TestType>(data,
+                                          [](auto a, auto b, auto c) { return ((a + b) * (c - a)).pow(3.0) - b * a; });
+}
+
+TEST_CASE("Fused expressions mix with values on either side", "[expression]") {
+    Value x(3.0);
+    Value y(2.0);
+    Value offset(1.0);
+
+    Value z = offset + lazy(x) * y - x;  // offset + (x * y) - x, with offset entering as an expression operand
+    REQUIRE(z.opcode() == Value::Op::Fused);
+    REQUIRE(z.op() == "fused");
+    REQUIRE(z.data() == 4.0);
+
+    // A fused node is an ordinary node of the surrounding graph
+    Value loss = z * z;
+    loss.backward();
+    REQUIRE(x.grad() == 8.0);   // 2z * (y - 1)
+    REQUIRE(y.grad() == 24.0);  // 2z * x
+    REQUIRE(offset.grad() == 8.0);
+}
+
+TEST_CASE("Fused expressions raise the errors of the per-op graph", "[expression]") {
+    Value a(2.0);
+    Value zero(0.0);
+    Value negative(-1.0);
+
+    REQUIRE_THROWS_AS(Value(lazy(a) / zero), std::runtime_error);
+    REQUIRE_THROWS_AS(Value(lazy(negative).pow(0.5)), std::runtime_error);
+    REQUIRE_THROWS_AS(Value((lazy(a) - a).pow(-1.0)), std::runtime_error);
+}
+
+TEST_CASE("Fused expressions record nothing in no-grad mode", "[expression][no_grad]") {
+    Value a(2.0);
+    Value b(3.0);
+
+    NoGradGuard guard;
+    Value c = (lazy(a) * b - a).pow(2.0);
+    REQUIRE(c.opcode() == Value::Op::Leaf);
+    REQUIRE(c.data() == 16.0);
+}
+
+TEST_CASE("Fused expressions allocate one node, exponents included", "[expression][arena]") {
+    GraphArena arena;
+    Value a(2.0);
+    NoLeakScope scope(arena);
+    Value c = (lazy(a).pow(2.0) * a).pow(0.5) + lazy(a).pow(3.0);
+    REQUIRE(arena.live_allocations() == 2);  // The fused node and its children array
+
+    c.backward();
+    REQUIRE(std::abs(c.data() - (std::sqrt(8.0) + 8.0)) < 1e-12);
+    REQUIRE(std::abs(a.grad() - (1.5 * std::sqrt(2.0) + 12.0)) < 1e-12);
+}
+
+TEST_CASE("Fused nodes backpropagate in a parallel backward", "[expression][parallel]") {
+    ThreadPool pool(4);
+    std::vector<Value> inputs;
+    std::vector<Value> serial_inputs;
+    Value total(0.0);
+    Value serial_total(0.0);
+    for (int i = 0; i < 64; ++i) {
+        inputs.emplace_back(0.1 * i);
+        serial_inputs.emplace_back(0.1 * i);
+    }
+    for (int i = 0; i < 63; ++i) {
+        total = total + Value((lazy(inputs[i]) - inputs[i + 1]).pow(2.0));
+        serial_total = serial_total + Value((lazy(serial_inputs[i]) - serial_inputs[i + 1]).pow(2.0));
+    }
+
+    total.backward(pool);
+    serial_total.backward();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        REQUIRE(std::abs(inputs[i].grad() - serial_inputs[i].grad()) < 1e-12);
+    }
+}
@@ -0,0 +1,114 @@
+#include "graph_file.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "expression.hpp"
+#include "neuron.hpp"
+#include "precision.hpp"
+#include "value.hpp"
+
+namespace {
+
+std::string temp_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("cppgrad_" + name)).string();
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Saved graphs load with the same nodes, data and gradients", "[graph_file]", double, float,
+                   BFloat16) {
+    using Value = BasicValue<TestType>;
+    BasicNeuron<TestType> neuron(3);
+    std::vector<Value> x = {Value(0.5), Value(-1.5), Value(2.0)};
+    Value target(0.25, false);
+    Value loss = (neuron(x) - target).pow(2.0) + (x[0] * x[1]).relu() / Value(3.0);
+    loss.backward();
+
+    const std::string path = temp_path("graph_round_trip.bin");
+    BasicGraphFile<TestType>::save(loss, path);
+    BasicGraphFile<TestType> file(path);
+    REQUIRE(file.size() == 16);  // 4 neuron weights, 3 inputs, the target, 3 and 7 ops
+    REQUIRE(file.op(file.root()) == Value::Op::Add);
+    REQUIRE(file.data(file.root()) == loss.data());
+    REQUIRE(file.grad(file.root()) == 1.0);
+
+    Value loaded = file.load();
+    std::remove(path.c_str());
+    REQUIRE(loaded.data() == loss.data());
+    REQUIRE(loaded.opcode() == Value::Op::Add);
+
+    // Replaying backward on the loaded graph doubles every saved gradient, as it does on the original
+    loaded.backward();
+    loss.backward();
+    BasicGraphFile<TestType>::save(loss, path);
+    BasicGraphFile<TestType> original(path);
+    BasicGraphFile<TestType>::save(loaded, path);
+    BasicGraphFile<TestType> replayed(path);
+    std::remove(path.c_str());
+    REQUIRE(replayed.size() == original.size());
+    for (size_t i = 0; i < original.size(); ++i) {
+        REQUIRE(replayed.op(i) == original.op(i));
+        REQUIRE(replayed.data(i) == original.data(i));
+        REQUIRE(replayed.requires_grad(i) == original.requires_grad(i));
+        const double expected = original.grad(i);
+        REQUIRE(std::abs(replayed.grad(i) - expected) <= tolerance<TestType>() * (1.0 + std::abs(expected)));
+        REQUIRE(replayed.children(i).size() == original.children(i).size());
+        for (size_t c = 0; c < original.children(i).size(); ++c) {
+            REQUIRE(replayed.children(i)[c] == original.children(i)[c]);
+        }
+    }
+}
+
+TEST_CASE("Graphs render to DOT", "[graph_file]") {
+    Value a(2.0);
+    Value b(3.0);
+    Value c = (a * b).pow(2.0);
+    c.backward();
+
+    const std::string dot = GraphFile::to_dot(c);
+    REQUIRE(dot.find("digraph cppgrad {") == 0);
+    REQUIRE(dot.find("n2 [label=\"{* | data 6 | grad 12}\"];") != std::string::npos);
+    REQUIRE(dot.find("n0 -> n2;") != std::string::npos);
+    REQUIRE(dot.find("n2 -> n3;") != std::string::npos);
+    REQUIRE(dot.find("{pow 2.000000 | data 36 | grad 1}") != std::string::npos);
+    REQUIRE_THROWS_AS(GraphFile::to_dot(c, 3), std::runtime_error);
+}
+
+TEST_CASE("Graph files reject what they cannot represent or read", "[graph_file]") {
+    Value a(2.0);
+    Value b(3.0);
+    const std::string path = temp_path("graph_errors.bin");
+
+    REQUIRE_THROWS_AS(GraphFile::save(Value(lazy(a) * b - a), path), std::runtime_error);
+    REQUIRE_THROWS_AS(GraphFile(temp_path("graph_missing.bin")), std::runtime_error);
+
+    GraphFile::save(a * b, path);
+    REQUIRE_THROWS_AS(BasicGraphFile<float>(path), std::runtime_error);
+
+    // Truncated file
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    REQUIRE_THROWS_AS(GraphFile(path), std::runtime_error);
+
+    // An edge pointing forward
+    GraphFile::save(a * b, path);
+    {
+        GraphFile file(path);
+        REQUIRE(file.children(2)[1] == 1);
+    }
+    const size_t edges_end = std::filesystem::file_size(path);
+    {
+        std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+        out.seekp(static_cast<std::streamoff>(edges_end - 4));
+        const std::uint32_t forward = 2;
+        out.write(reinterpret_cast<const char*>(&forward), sizeof(forward));
+    }
+    REQUIRE_THROWS_AS(GraphFile(path), std::runtime_error);
+    std::remove(path.c_str());
+}
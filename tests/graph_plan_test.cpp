@@ -0,0 +1,288 @@
+#include "graph_plan.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "expression.hpp"
+#include "neuron.hpp"
+#include "precision.hpp"
+#include "thread_pool.hpp"
+#include "value.hpp"
+
+namespace {
+
+// Two hidden neurons and an output neuron trained on a squared error
+template <typename T>
+struct TinyNet {
+    using Value = BasicValue<T>;
+    std::vector<BasicNeuron<T>> hidden = {BasicNeuron<T>(3), BasicNeuron<T>(3)};
+    BasicNeuron<T> output = BasicNeuron<T>(2, false);
+
+    Value loss(const std::vector<Value>& x, const Value& target) {
+        std::vector<Value> h = {hidden[0](x), hidden[1](x)};
+        return (output(h) - target).pow(2.0) + (x[0] * x[1]) / target;
+    }
+
+    std::vector<Value> parameters() {
+        std::vector<Value> params;
+        for (auto* neuron : {&hidden[0], &hidden[1], &output}) {
+            for (const Value& p : neuron->parameters()) params.push_back(p);
+        }
+        return params;
+    }
+
+    void zero_grad() {
+        for (Value& p : parameters()) p.set_grad(0.0);
+    }
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Replaying a plan matches rebuilding the graph", "[graph_plan]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    TinyNet<TestType> net;
+    std::vector<Value> x = {Value(0.5), Value(-1.0), Value(2.0)};
+    Value target(0.25);
+
+    BasicGraphPlan<TestType> plan = BasicGraphPlan<TestType>::capture(net.loss(x, target));
+    REQUIRE(plan.size() > 0);
+
+    const std::vector<std::vector<double>> batches = {{0.1, 0.2, 0.3}, {-0.7, 1.5, 0.9}, {2.0, -0.5, -1.0}};
+    for (const auto& batch : batches) {
+        for (size_t i = 0; i < x.size(); ++i) x[i].set_data(batch[i]);
+        target.set_data(batch[0] + 1.0);
+
+        net.zero_grad();
+        Value rebuilt = net.loss(x, target);
+        rebuilt.backward();
+        std::vector<double> expected;
+        for (const Value& p : net.parameters()) expected.push_back(p.grad());
+
+        net.zero_grad();
+        REQUIRE(plan.forward() == rebuilt.data());
+        plan.backward();
+        std::vector<Value> params = net.parameters();
+        for (size_t i = 0; i < params.size(); ++i) {
+            REQUIRE(params[i].grad() == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("Plans replay fused expressions and parallel backward", "[graph_plan]") {
+    Value a(1.5);
+    Value b(-2.0);
+    GraphPlan plan = GraphPlan::capture((lazy(a) * b - a).pow(2.0) + a * b);
+
+    a.set_data(0.5);
+    b.set_data(3.0);
+    REQUIRE(plan.forward() == 2.5);  // (1.5 - 0.5)^2 + 1.5
+    ThreadPool pool(3);
+    plan.backward(pool);
+    REQUIRE(a.grad() == 7.0);  // 2 * 1 * (b - 1) + b
+    REQUIRE(b.grad() == 1.5);  // 2 * 1 * a + a
+}
+
+TEST_CASE("Plans raise the errors of the ops they replay", "[graph_plan]") {
+    Value a(1.0);
+    Value b(2.0);
+    GraphPlan plan = GraphPlan::capture(a / b);
+    b.set_data(0.0);
+    REQUIRE_THROWS_AS(plan.forward(), std::runtime_error);
+}
+
+TEST_CASE("Plans only match graphs computing the same thing", "[graph_plan]") {
+    Value a(1.0);
+    Value b(2.0);
+    GraphPlan plan = GraphPlan::capture((a * b + Value(3.0, false)).pow(2.0));
+
+    REQUIRE(plan.matches((a * b + Value(3.0, false)).pow(2.0)));
+    REQUIRE_FALSE(plan.matches((a * b + Value(4.0, false)).pow(2.0)));
+    REQUIRE_FALSE(plan.matches((b * a + Value(3.0, false)).pow(2.0)));
+    REQUIRE_FALSE(plan.matches((a * b + Value(3.0, false)).pow(3.0)));
+    REQUIRE_FALSE(plan.matches((a * b - Value(3.0, false)).pow(2.0)));
+    REQUIRE_FALSE(plan.matches(a * b));
+
+    // Leaves that require grad are matched by identity, not by value
+    Value a_copy(1.0);
+    REQUIRE_FALSE(plan.matches((a_copy * b + Value(3.0, false)).pow(2.0)));
+    REQUIRE_FALSE(plan.matches((a * b + Value(3.0)).pow(2.0)));
+}
+
+TEST_CASE("Captured steps replay until their control flow changes", "[graph_plan]") {
+    Value x(2.0);
+    Value w(3.0);
+    auto build = [&] { return x.data() > 0 ? (w * x).pow(2.0) : w - x; };
+
+    CapturedStep step(build, 1);
+    REQUIRE(step() == 36.0);
+    REQUIRE(step.captured());
+    REQUIRE(w.grad() == 24.0);
+
+    x.set_data(1.0);
+    w.set_grad(0.0);
+    REQUIRE(step() == 9.0);  // Same branch: replayed
+    REQUIRE(step.recaptures() == 0);
+    REQUIRE(w.grad() == 6.0);
+
+    x.set_data(-1.0);
+    w.set_grad(0.0);
+    REQUIRE(step() == 4.0);  // Other branch: run dynamically and recaptured
+    REQUIRE(step.recaptures() == 1);
+    REQUIRE(w.grad() == 1.0);
+
+    CapturedStep strict(build, 1, true);
+    strict();
+    x.set_data(1.0);
+    REQUIRE_THROWS_AS(strict(), std::runtime_error);
+}
+
+TEST_CASE("Captured steps verify their control flow by default", "[graph_plan]") {
+    Value x(2.0);
+    Value w(3.0);
+    CapturedStep step([&] { return x.data() > 0 ? w * x : w - x; });
+    step();
+    x.set_data(-1.0);
+    REQUIRE(step() == 4.0);  // The first step after the change already runs the new graph
+    REQUIRE(step.recaptures() == 1);
+
+    // A longer interval is an explicit opt-in and only notices the change on a verified step
+    CapturedStep sparse([&] { return x.data() > 0 ? w * x : w - x; }, 4);
+    sparse();
+    x.set_data(2.0);
+    for (size_t i = 0; i < 2; ++i) sparse();
+    REQUIRE(sparse.recaptures() == 0);
+    REQUIRE(sparse() == 6.0);
+    REQUIRE(sparse.recaptures() == 1);
+
+    CapturedStep unchecked([&] { return x.data() > 0 ? w * x : w - x; }, 0);
+    unchecked();
+    x.set_data(-1.0);
+    for (size_t i = 0; i < 16; ++i) unchecked();
+    REQUIRE(unchecked.recaptures() == 0);
+}
+
+TEST_CASE("Optimizing a plan merges duplicate nodes", "[graph_plan][optimize]") {
+    Value a(2.0);
+    Value b(3.0);
+    GraphPlan plan = GraphPlan::capture((a + b) * (a + b));
+
+    GraphPassReport report = plan.optimize();
+    REQUIRE(report.nodes_before == 5);
+    REQUIRE(report.nodes_after == 4);
+    REQUIRE(report.deduplicated == 1);
+    REQUIRE(plan.size() == 2);
+
+    REQUIRE(plan.forward() == 25.0);
+    plan.backward();
+    REQUIRE(a.grad() == 10.0);
+    REQUIRE(b.grad() == 10.0);
+}
+
+TEST_CASE("Optimizing a plan merges fused nodes only when their exponents match", "[graph_plan][optimize]") {
+    Value a(2.0);
+    Value b(3.0);
+    GraphPlan plan = GraphPlan::capture((lazy(a).pow(2.0) + b).value() * (lazy(a).pow(2.0) + b).value() +
+                                        (lazy(a).pow(3.0) + b).value());
+
+    GraphPassReport report = plan.optimize();
+    REQUIRE(report.nodes_before == 7);
+    REQUIRE(report.deduplicated == 1);
+
+    REQUIRE(plan.forward() == 60.0);
+    plan.backward();
+    REQUIRE(a.grad() == 68.0);
+    REQUIRE(b.grad() == 15.0);
+}
+
+TEST_CASE("Optimizing a plan invalidates topologies cached on its nodes", "[graph_plan][optimize]") {
+    Value a(2.0);
+    Value b(3.0);
+    Value sum = a * b + a * b;  // The second product is only held by `sum`, and is freed once merged
+    Value loss = sum * Value(0.5);
+    Value other = sum * Value(3.0);  // A second root over the same subgraph, outside the plan
+    sum.backward(true);
+    other.backward(true);
+    GraphPlan plan = GraphPlan::capture(loss);
+
+    GraphPassReport report = plan.optimize();
+    REQUIRE(report.deduplicated == 1);
+
+    // The plan's backward resets the interior gradients: loss 1, sum 0.5, the product 1
+    plan.backward();
+    a.set_grad(0.0);
+    b.set_grad(0.0);
+    sum.backward(true);  // The product receives 2 * 1 more
+    REQUIRE(a.grad() == 3.0 * 3.0);
+    REQUIRE(b.grad() == 3.0 * 2.0);
+
+    plan.backward();
+    a.set_grad(0.0);
+    b.set_grad(0.0);
+    other.backward(true);  // sum receives 3 more, the product 2 * 3.5
+    REQUIRE(a.grad() == 8.0 * 3.0);
+    REQUIRE(b.grad() == 8.0 * 2.0);
+}
+
+TEST_CASE("Optimizing a plan folds constant subtrees", "[graph_plan][optimize]") {
+    Value x(2.0);
+    Value w(0.5);
+    // Everything built from the temporaries is constant: 3 * 4 + 1 and its duplicate fold into one leaf,
+    // and so does their ratio
+    Value ratio = (Value(3.0) * Value(4.0) + Value(1.0)) / (Value(3.0) * Value(4.0) + Value(1.0));
+    GraphPlan plan = GraphPlan::capture(w * x + ratio);
+    ratio = Value(0.0);  // Only the plan refers to the subtree now
+
+    GraphPassReport report = plan.optimize();
+    REQUIRE(report.folded == 5);
+    REQUIRE(report.nodes_after == 5);  // w, x, w * x, the folded ratio and the sum
+    REQUIRE(plan.size() == 2);
+
+    x.set_data(4.0);
+    REQUIRE(plan.forward() == 3.0);
+    plan.backward();
+    REQUIRE(w.grad() == 4.0);
+    REQUIRE(x.grad() == 0.5);
+}
+
+TEST_CASE("Optimizing a plan prunes backward work that reaches no parameter", "[graph_plan][optimize]") {
+    Value x(2.0);
+    Value w(0.5);
+    GraphPlan plan = GraphPlan::capture(w * x + (x * x).relu());
+
+    GraphPassReport report = plan.optimize({w});
+    REQUIRE(report.pruned == 2);  // x * x and its ReLU
+    REQUIRE(report.nodes_after == report.nodes_before);
+
+    REQUIRE(plan.forward() == 5.0);
+    plan.backward();
+    REQUIRE(w.grad() == 2.0);
+    REQUIRE(x.grad() == 0.5);  // Through w * x only, none through x * x
+}
+
+TEMPLATE_TEST_CASE("Optimized plans keep the gradients of the original graph", "[graph_plan][optimize]", double, float,
+                   BFloat16) {
+    using Value = BasicValue<TestType>;
+    TinyNet<TestType> net;
+    std::vector<Value> x = {Value(0.5), Value(-1.0), Value(2.0)};
+    Value target(0.25);
+    auto build = [&] { return net.loss(x, target) + net.loss(x, target) * Value(0.5); };
+
+    Value reference = build();
+    reference.backward();
+    std::vector<double> expected;
+    for (const Value& p : net.parameters()) expected.push_back(p.grad());
+
+    BasicGraphPlan<TestType> plan = BasicGraphPlan<TestType>::capture(build());
+    GraphPassReport report = plan.optimize(net.parameters());
+    REQUIRE(report.nodes_after < report.nodes_before);
+
+    net.zero_grad();
+    REQUIRE(plan.forward() == reference.data());
+    plan.backward();
+    std::vector<Value> params = net.parameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+        REQUIRE(std::abs(params[i].grad() - expected[i]) <= tolerance<TestType>() * (1.0 + std::abs(expected[i])));
+    }
+}
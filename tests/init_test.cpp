@@ -0,0 +1,93 @@
+#include "init.hpp"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <vector>
+
+#include "layer.hpp"
+#include "mlp.hpp"
+#include "neuron.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+std::vector<double> snapshot(Module& module) {
+    Span<double> data = module.data_buffer();
+    return std::vector<double>(data.begin(), data.end());
+}
+
+}  // namespace
+
+TEST_CASE("Philox matches the Random123 known-answer vectors", "[init]") {
+    REQUIRE(Philox(0)({0, 0, 0, 0}) == Philox::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    REQUIRE(Philox(0x299f31d0a4093822ull)({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}) ==
+            Philox::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("Seeding the init streams reproduces models", "[init]") {
+    set_init_seed(42);
+    MLP first(8, {16, 4}, InitScheme::HeNormal);
+    Neuron neuron(5);
+    set_init_seed(42);
+    MLP second(8, {16, 4}, InitScheme::HeNormal);
+    Neuron same_neuron(5);
+    REQUIRE(init_seed() == 42);
+    REQUIRE(snapshot(first) == snapshot(second));
+    REQUIRE(snapshot(neuron) == snapshot(same_neuron));
+
+    // Each module draws its own stream, and another seed gives other weights
+    MLP third(8, {16, 4}, InitScheme::HeNormal);
+    REQUIRE(snapshot(third) != snapshot(first));
+    set_init_seed(43);
+    MLP reseeded(8, {16, 4}, InitScheme::HeNormal);
+    REQUIRE(snapshot(reseeded) != snapshot(first));
+}
+
+TEST_CASE("Parallel initialization matches serial initialization", "[init]") {
+    ThreadPool pool(4);
+    set_init_seed(7);
+    Layer serial(300, 200, true, InitScheme::XavierUniform);
+    set_init_seed(7);
+    Layer parallel(300, 200, true, InitScheme::XavierUniform, &pool);
+    REQUIRE(snapshot(parallel) == snapshot(serial));
+}
+
+TEST_CASE("Init schemes have the right spread", "[init]") {
+    const InitStream stream(1, 0);
+    std::vector<double> weights(200000);
+    auto moments = [&](double& mean, double& variance, double& largest) {
+        mean = variance = largest = 0.0;
+        for (double w : weights) {
+            mean += w;
+            largest = std::max(largest, std::abs(w));
+        }
+        mean /= static_cast<double>(weights.size());
+        for (double w : weights) variance += (w - mean) * (w - mean);
+        variance /= static_cast<double>(weights.size());
+    };
+    double mean, variance, largest;
+
+    init_weights(Span<double>(weights.data(), weights.size()), InitScheme::XavierUniform, 100, 200, stream);
+    moments(mean, variance, largest);
+    const double bound = std::sqrt(6.0 / 300.0);
+    REQUIRE(largest <= bound);
+    REQUIRE(std::abs(mean) < 0.01 * bound);
+    REQUIRE(std::abs(variance - bound * bound / 3.0) < 0.02 * bound * bound / 3.0);
+
+    init_weights(Span<double>(weights.data(), weights.size()), InitScheme::HeNormal, 50, 10, stream);
+    moments(mean, variance, largest);
+    REQUIRE(std::abs(mean) < 0.01);
+    REQUIRE(std::abs(variance - 2.0 / 50.0) < 0.02 * 2.0 / 50.0);
+
+    init_weights(Span<double>(weights.data(), weights.size()), InitScheme::Uniform, 1, 1, stream);
+    moments(mean, variance, largest);
+    REQUIRE(largest <= 1.0);
+    REQUIRE(std::abs(variance - 1.0 / 3.0) < 0.01);
+
+    // Lower precisions round the same draws
+    std::vector<float> floats(16);
+    init_weights(Span<float>(floats.data(), floats.size()), InitScheme::HeUniform, 4, 4, stream);
+    init_weights(Span<double>(weights.data(), floats.size()), InitScheme::HeUniform, 4, 4, stream);
+    for (size_t i = 0; i < floats.size(); ++i) REQUIRE(floats[i] == static_cast<float>(weights[i]));
+}
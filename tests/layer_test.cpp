@@ -0,0 +1,107 @@
+#include "layer.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+
+#include "mlp.hpp"
+#include "tensor.hpp"
+#include "value.hpp"
+
+TEST_CASE("Value views alias external storage", "[layer]") {
+    Tensor t({2}, {1.0, 2.0});
+    std::vector<Value> views = t.values();
+    views[1].set_data(5.0);
+    views[0].set_grad(3.0);
+    REQUIRE(t.at({1}) == 5.0);
+    REQUIRE(t.grad_at({0}) == 3.0);
+
+    Value y = views[0] * views[1];
+    y.backward();
+    REQUIRE(t.grad_at({0}) == 8.0);  // 3 + d(y)/d(views[0])
+}
+
+TEST_CASE("Layer construction", "[layer]") {
+    Layer layer(3, 4);
+    auto params = layer.parameters();
+    REQUIRE(params.size() == 16);  // 3 * 4 weights + 4 biases
+    REQUIRE(params.back().data() == 0.0);
+    REQUIRE(layer.input_size() == 3);
+    REQUIRE(layer.output_size() == 4);
+    REQUIRE(layer.str() == "ReLULayer(3, 4)");
+    REQUIRE(Layer(2, 1, false).str() == "LinearLayer(2, 1)");
+}
+
+TEST_CASE("Layer minibatch forward matches per-sample neurons", "[layer]") {
+    Layer layer(3, 2, false);
+    auto params = layer.parameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+        params[i].set_data(0.1 * static_cast<double>(i) - 0.3);
+    }
+
+    Tensor x({2, 3}, {1, 2, 3, -1, 0.5, 4});
+    Tensor out = layer(x);
+    REQUIRE(out.shape() == std::vector<size_t>{2, 2});
+
+    for (size_t b = 0; b < 2; ++b) {
+        for (size_t j = 0; j < 2; ++j) {
+            double expected = params[6 + j].data();  // bias
+            for (size_t i = 0; i < 3; ++i) {
+                expected += x.at({b, i}) * params[i * 2 + j].data();
+            }
+            REQUIRE(std::abs(out.at({b, j}) - expected) < 1e-12);
+        }
+    }
+}
+
+TEST_CASE("Layer backward fills parameter gradients", "[layer]") {
+    Layer layer(2, 2);
+    auto params = layer.parameters();
+    for (auto& p : params) p.set_data(1.0);
+
+    Tensor x({3, 2}, {1, 2, 3, 4, -5, -6});
+    layer(x).sum().backward();
+
+    // Third sample is clamped by ReLU, so only the first two contribute
+    REQUIRE(params[0].grad() == 4.0);  // w[0][0]: 1 + 3
+    REQUIRE(params[3].grad() == 6.0);  // w[1][1]: 2 + 4
+    REQUIRE(params[4].grad() == 2.0);  // bias[0]
+
+    layer.zero_grad();
+    for (const auto& p : params) {
+        REQUIRE(p.grad() == 0.0);
+    }
+}
+
+TEST_CASE("Layer rejects mismatched input", "[layer]") {
+    Layer layer(3, 2);
+    REQUIRE_THROWS_AS(layer(Tensor({2, 2}, 1.0)), std::runtime_error);
+    REQUIRE_THROWS_AS(layer(Tensor({3}, 1.0)), std::runtime_error);
+}
+
+TEST_CASE("MLP construction and forward", "[layer]") {
+    MLP mlp(3, {4, 4, 1});
+    REQUIRE(mlp.layers().size() == 3);
+    REQUIRE(mlp.parameters().size() == (3 * 4 + 4) + (4 * 4 + 4) + (4 * 1 + 1));
+    REQUIRE(mlp.str() == "MLP(ReLULayer(3, 4), ReLULayer(4, 4), LinearLayer(4, 1))");
+
+    Tensor out = mlp(Tensor({5, 3}, 0.5));
+    REQUIRE(out.shape() == std::vector<size_t>{5, 1});
+}
+
+TEST_CASE("MLP training reduces the loss", "[layer]") {
+    MLP mlp(2, {8, 1});
+    Tensor x({4, 2}, {0, 0, 0, 1, 1, 0, 1, 1});
+    Tensor y({4, 1}, {0, 1, 1, 2});
+
+    auto loss_fn = [&]() { return (mlp(x) - y).pow(2.0).mean(); };
+    double initial = loss_fn().item();
+    for (int step = 0; step < 200; ++step) {
+        mlp.zero_grad();
+        Tensor loss = loss_fn();
+        loss.backward();
+        for (auto& p : mlp.parameters()) {
+            p.set_data(p.data() - 0.05 * p.grad());
+        }
+    }
+    REQUIRE(loss_fn().item() < initial);
+}
@@ -0,0 +1,93 @@
+#include "module.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include "layer.hpp"
+#include "mlp.hpp"
+#include "neuron.hpp"
+#include "parameter_buffer.hpp"
+#include "value.hpp"
+
+namespace {
+
+// Checks that parameter_view() and the flat buffers describe the same parameters as parameters()
+void check_flat_layout(Module& module) {
+    std::vector<Value> params = module.parameters();
+    Span<Value> view = module.parameter_view();
+    Span<double> data = module.data_buffer();
+    Span<double> grad = module.grad_buffer();
+    REQUIRE(view.size() == params.size());
+    REQUIRE(data.size() == params.size());
+    REQUIRE(grad.size() == params.size());
+
+    for (size_t i = 0; i < params.size(); ++i) {
+        data[i] = static_cast<double>(i);
+        grad[i] = 1.0;
+    }
+    for (size_t i = 0; i < params.size(); ++i) {
+        REQUIRE(params[i].data() == static_cast<double>(i));
+        REQUIRE(view[i].grad() == 1.0);
+    }
+
+    module.zero_grad();
+    for (const auto& p : params) {
+        REQUIRE(p.grad() == 0.0);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Neuron parameters live in one flat buffer", "[module]") {
+    Neuron n(5);
+    check_flat_layout(n);
+}
+
+TEST_CASE("Layer parameters live in one flat buffer", "[module]") {
+    Layer layer(3, 4);
+    check_flat_layout(layer);
+}
+
+TEST_CASE("MLP layers share one flat buffer", "[module]") {
+    MLP mlp(3, {4, 2});
+    check_flat_layout(mlp);
+
+    Layer& first = mlp.layers()[0];
+    Layer& second = mlp.layers()[1];
+    REQUIRE(first.data_buffer().data() == mlp.data_buffer().data());
+    REQUIRE(second.data_buffer().data() == mlp.data_buffer().data() + first.parameter_view().size());
+}
+
+TEST_CASE("Gradients land in the flat buffer", "[module]") {
+    Neuron n(2, false);
+    Span<double> data = n.data_buffer();
+    data[0] = 2.0;
+    data[1] = -1.0;
+    data[2] = 0.5;
+
+    Value x0(3.0);
+    Value x1(4.0);
+    n({x0, x1}).backward();
+    Span<double> grad = n.grad_buffer();
+    REQUIRE(grad[0] == 3.0);
+    REQUIRE(grad[1] == 4.0);
+    REQUIRE(grad[2] == 1.0);
+}
+
+TEST_CASE("ParameterBuffer views", "[module]") {
+    auto buffer = ParameterBuffer::create(6);
+    Tensor t = buffer->tensor(2, {2, 2});
+    std::vector<Value> values = buffer->values(0, 6);
+    values[3].set_data(7.0);
+    REQUIRE(t.at({0, 1}) == 7.0);
+    REQUIRE(buffer->data()[3] == 7.0);
+
+    REQUIRE_THROWS_AS(buffer->values(4, 3), std::runtime_error);
+    REQUIRE_THROWS_AS(buffer->tensor(3, {2, 2}), std::runtime_error);
+
+    std::weak_ptr<ParameterBuffer> weak = buffer;
+    buffer.reset();
+    REQUIRE_FALSE(weak.expired());  // kept alive by its views
+    values.clear();
+    t = Tensor({1}, 0.0);
+    REQUIRE(weak.expired());
+}
@@ -2,23 +2,31 @@
 
 #include <catch2/catch_all.hpp>
 #include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
 
+#include "precision.hpp"
 #include "value.hpp"
 
-TEST_CASE("Neuron construction with ReLU", "[neuron]") {
+TEMPLATE_TEST_CASE("Neuron construction with ReLU", "[neuron]", double, float, BFloat16) {
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(3);
     auto params = n.parameters();
     REQUIRE(params.size() == 4);           // 3 weights + 1 bias
     REQUIRE(params.back().data() == 0.0);  // bias initialized to 0
 }
 
-TEST_CASE("Neuron construction without ReLU", "[neuron]") {
+TEMPLATE_TEST_CASE("Neuron construction without ReLU", "[neuron]", double, float, BFloat16) {
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(2, false);
     auto params = n.parameters();
     REQUIRE(params.size() == 3);  // 2 weights + 1 bias
 }
 
-TEST_CASE("Linear neuron forward pass", "[neuron]") {
+TEMPLATE_TEST_CASE("Linear neuron forward pass", "[neuron]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(2, false);
     auto params = n.parameters();
     params[0].set_data(1.0);  // First weight
@@ -27,10 +35,12 @@ TEST_CASE("Linear neuron forward pass", "[neuron]") {
 
     std::vector<Value> input = {Value(2.0), Value(3.0)};
     Value output = n(input);
-    REQUIRE(std::abs(output.data() - 5.0) < 1e-6);  // 2*1 + 3*1 + 0
+    REQUIRE(std::abs(output.data() - 5.0) < tolerance<TestType>());  // 2*1 + 3*1 + 0
 }
 
-TEST_CASE("ReLU neuron forward pass with positive output", "[neuron]") {
+TEMPLATE_TEST_CASE("ReLU neuron forward pass with positive output", "[neuron]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(2, true);
     auto params = n.parameters();
     params[0].set_data(1.0);
@@ -39,10 +49,12 @@ TEST_CASE("ReLU neuron forward pass with positive output", "[neuron]") {
 
     std::vector<Value> input = {Value(2.0), Value(3.0)};
     Value output = n(input);
-    REQUIRE(std::abs(output.data() - 5.0) < 1e-6);
+    REQUIRE(std::abs(output.data() - 5.0) < tolerance<TestType>());
 }
 
-TEST_CASE("ReLU neuron forward pass with negative output", "[neuron]") {
+TEMPLATE_TEST_CASE("ReLU neuron forward pass with negative output", "[neuron]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(2, true);
     auto params = n.parameters();
     params[0].set_data(-1.0);
@@ -51,10 +63,11 @@ TEST_CASE("ReLU neuron forward pass with negative output", "[neuron]") {
 
     std::vector<Value> input = {Value(2.0), Value(3.0)};
     Value output = n(input);
-    REQUIRE(std::abs(output.data() - 0.0) < 1e-6);  // ReLU clamps negative to 0
+    REQUIRE(std::abs(output.data() - 0.0) < tolerance<TestType>());  // ReLU clamps negative to 0
 }
 
-TEST_CASE("Neuron gradient operations", "[neuron]") {
+TEMPLATE_TEST_CASE("Neuron gradient operations", "[neuron]", double, float, BFloat16) {
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(2);
     auto params = n.parameters();
 
@@ -77,12 +90,123 @@ TEST_CASE("Neuron gradient operations", "[neuron]") {
     }
 }
 
-TEST_CASE("ReLU neuron string representation", "[neuron]") {
+TEMPLATE_TEST_CASE("ReLU neuron string representation", "[neuron]", double, float, BFloat16) {
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(3);
     REQUIRE(n.str() == "ReLUNeuron(4)");  // 3 weights + 1 bias
 }
 
-TEST_CASE("Linear neuron string representation", "[neuron]") {
+TEMPLATE_TEST_CASE("Linear neuron string representation", "[neuron]", double, float, BFloat16) {
+    using Neuron = BasicNeuron<TestType>;
     Neuron n(3, false);
     REQUIRE(n.str() == "LinearNeuron(4)");  // 3 weights + 1 bias
 }
+
+TEMPLATE_TEST_CASE("Fused linear matches the unfused chain of ops", "[neuron]", double, float) {
+    using Value = BasicValue<TestType>;
+    for (bool use_relu : {false, true}) {
+        for (double bias : {0.25, -40.0}) {
+            std::vector<Value> fused_params;
+            std::vector<Value> fused_inputs;
+            std::vector<Value> params;
+            std::vector<Value> inputs;
+            for (int i = 0; i < 17; ++i) {
+                double w = std::sin(1.3 * i);
+                double x = std::cos(0.7 * i) * 3.0;
+                fused_params.emplace_back(w);
+                fused_inputs.emplace_back(x);
+                params.emplace_back(w);
+                inputs.emplace_back(x);
+            }
+            fused_params.emplace_back(bias);
+            params.emplace_back(bias);
+
+            Value fused = Value::linear(fused_params, fused_inputs, use_relu);
+            Value activation = std::inner_product(params.begin(), params.end() - 1, inputs.begin(), params.back());
+            Value unfused = use_relu ? activation.relu() : activation;
+            REQUIRE(fused.data() == unfused.data());
+
+            (fused * fused).backward();
+            (unfused * unfused).backward();
+            for (size_t i = 0; i < params.size(); ++i) {
+                REQUIRE(fused_params[i].grad() == params[i].grad());
+            }
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                REQUIRE(fused_inputs[i].grad() == inputs[i].grad());
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Neuron forward records a single node", "[neuron]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    using Neuron = BasicNeuron<TestType>;
+    Neuron relu(3);
+    Neuron linear(3, false);
+    std::vector<Value> input = {Value(1.0), Value(2.0), Value(3.0)};
+    REQUIRE(relu(input).op() == "linear+ReLU");
+    REQUIRE(linear(input).op() == "linear");
+    REQUIRE_THROWS_AS(relu({Value(1.0)}), std::runtime_error);
+}
+
+TEMPLATE_TEST_CASE("Batch forward matches per-sample evaluation", "[neuron][batch]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    using Scalar = typename Value::Scalar;
+    const size_t input_size = 37;  // Exercises the vector tails
+    const size_t rows = 5;
+    for (bool relu : {true, false}) {
+        BasicNeuron<TestType> n(input_size, relu);
+        n.parameters().back().set_data(0.25);
+        std::vector<Scalar> inputs(rows * input_size);
+        for (size_t i = 0; i < inputs.size(); ++i) inputs[i] = Scalar(std::sin(0.7 * i));
+
+        std::vector<Scalar> outputs = n.forward_batch(inputs);
+        REQUIRE(outputs.size() == rows);
+        for (size_t r = 0; r < rows; ++r) {
+            std::vector<Value> x;
+            for (size_t i = 0; i < input_size; ++i) x.emplace_back(inputs[r * input_size + i]);
+            REQUIRE(std::abs(outputs[r] - n(x).data()) < 10 * tolerance<TestType>());
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Batch backward matches per-sample backward", "[neuron][batch]", double, float) {
+    using Value = BasicValue<TestType>;
+    const size_t input_size = 19;
+    const size_t rows = 4;
+    BasicNeuron<TestType> n(input_size);
+    std::vector<TestType> inputs(rows * input_size);
+    for (size_t i = 0; i < inputs.size(); ++i) inputs[i] = TestType(std::cos(0.3 * i));
+    const std::vector<TestType> output_grads = {1.0, -0.5, 2.0, 0.25};
+
+    std::vector<double> expected_params(input_size + 1, 0.0);
+    std::vector<double> expected_inputs(inputs.size());
+    for (size_t r = 0; r < rows; ++r) {
+        std::vector<Value> x;
+        for (size_t i = 0; i < input_size; ++i) x.emplace_back(inputs[r * input_size + i]);
+        Value out = n(x) * Value(output_grads[r]);
+        out.backward();
+        for (size_t i = 0; i < input_size; ++i) expected_inputs[r * input_size + i] = x[i].grad();
+    }
+    std::vector<Value> params = n.parameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+        expected_params[i] = params[i].grad();
+        params[i].set_grad(0.0);
+    }
+
+    std::vector<TestType> outputs(rows);
+    std::vector<TestType> input_grads(inputs.size(), 0);
+    n.forward_batch(inputs.data(), rows, outputs.data());
+    n.backward_batch(inputs.data(), rows, outputs.data(), output_grads.data(), input_grads.data());
+    for (size_t i = 0; i < params.size(); ++i) {
+        REQUIRE(std::abs(params[i].grad() - expected_params[i]) < 10 * tolerance<TestType>());
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        REQUIRE(std::abs(input_grads[i] - expected_inputs[i]) < 10 * tolerance<TestType>());
+    }
+}
+
+TEST_CASE("Batch forward rejects a ragged input matrix", "[neuron][batch]") {
+    Neuron n(3);
+    REQUIRE_THROWS_AS(n.forward_batch(std::vector<double>(7)), std::runtime_error);
+}
@@ -0,0 +1,96 @@
+#include "optimizer.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+
+#include "mlp.hpp"
+#include "neuron.hpp"
+#include "tensor.hpp"
+#include "value.hpp"
+
+namespace {
+
+// Module without flat buffers
+class Scalars : public Module {
+   public:
+    std::vector<Value> values = {Value(1.0)};
+    std::vector<Value> parameters() override { return values; }
+};
+
+void set_state(Module& module, double data, double grad) {
+    for (auto& p : module.parameter_view()) {
+        p.set_data(data);
+        p.set_grad(grad);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("SGD step", "[optimizer]") {
+    Neuron n(2);
+    set_state(n, 1.0, 0.5);
+    SGD sgd(n, 0.1);
+    sgd.step();
+    for (const auto& p : n.parameter_view()) {
+        REQUIRE(std::abs(p.data() - 0.95) < 1e-12);
+    }
+    sgd.zero_grad();
+    REQUIRE(n.parameter_view()[0].grad() == 0.0);
+}
+
+TEST_CASE("SGD with momentum and weight decay", "[optimizer]") {
+    Neuron n(1);
+    set_state(n, 1.0, 1.0);
+    SGD sgd(n, 0.1, 0.9, 0.5);
+    sgd.step();  // v = 1 + 0.5 = 1.5, p = 1 - 0.15 = 0.85
+    REQUIRE(std::abs(n.parameter_view()[0].data() - 0.85) < 1e-12);
+    sgd.step();  // v = 0.9 * 1.5 + 1 + 0.425 = 2.775, p = 0.85 - 0.2775
+    REQUIRE(std::abs(n.parameter_view()[0].data() - 0.5725) < 1e-12);
+}
+
+TEST_CASE("Adam first step moves every parameter by the learning rate", "[optimizer]") {
+    Neuron n(3);
+    set_state(n, 1.0, 0.0);
+    n.grad_buffer()[0] = 2.0;
+    n.grad_buffer()[1] = -0.001;
+    Adam adam(n, 0.01);
+    adam.step();
+    REQUIRE(std::abs(n.data_buffer()[0] - 0.99) < 1e-9);
+    REQUIRE(std::abs(n.data_buffer()[1] - 1.01) < 1e-6);
+    REQUIRE(n.data_buffer()[2] == 1.0);  // zero gradient, no update
+}
+
+TEST_CASE("AdamW decays parameters independently of the gradient", "[optimizer]") {
+    Neuron n(1);
+    set_state(n, 2.0, 0.0);
+    AdamW adamw(n, 0.1, 0.9, 0.999, 1e-8, 0.5);
+    adamw.step();
+    REQUIRE(std::abs(n.data_buffer()[0] - 1.9) < 1e-12);  // 2 * (1 - 0.1 * 0.5)
+
+    Neuron m(1);
+    set_state(m, 2.0, 0.0);
+    Adam adam(m, 0.1, 0.9, 0.999, 1e-8, 0.5);
+    adam.step();  // L2 term goes through the moments: a full learning-rate step
+    REQUIRE(std::abs(m.data_buffer()[0] - 1.9) < 1e-6);
+}
+
+TEST_CASE("Optimizer requires flat buffers", "[optimizer]") {
+    Scalars scalars;
+    REQUIRE_THROWS_AS(SGD(scalars, 0.1), std::runtime_error);
+}
+
+TEST_CASE("Adam trains an MLP", "[optimizer]") {
+    MLP mlp(2, {8, 1});
+    Tensor x({4, 2}, {0, 0, 0, 1, 1, 0, 1, 1});
+    Tensor y({4, 1}, {0, 1, 1, 0});
+    Adam adam(mlp, 0.05);
+
+    auto loss_fn = [&]() { return (mlp(x) - y).pow(2.0).mean(); };
+    double initial = loss_fn().item();
+    for (int step = 0; step < 300; ++step) {
+        adam.zero_grad();
+        loss_fn().backward();
+        adam.step();
+    }
+    REQUIRE(loss_fn().item() < initial);
+}
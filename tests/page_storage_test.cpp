@@ -0,0 +1,56 @@
+#include "page_storage.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <catch2/catch_all.hpp>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string temp_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("cppgrad_" + name)).string();
+}
+
+}  // namespace
+
+TEST_CASE("Page storage maps whole pages of a file and reads the rest", "[page_storage]") {
+    const size_t page = PageStorage::page_size();
+    std::vector<char> bytes(3 * page);
+    for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<char>(i * 7 + 1);
+    const std::string path = temp_path("pages.bin");
+    std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    REQUIRE(fd >= 0);
+
+    PageStorage storage(3 * page);
+    REQUIRE(storage.size() == 3 * page);
+    auto data = static_cast<char*>(storage.data());
+    REQUIRE(data[0] == 0);
+
+    // From mid-page to the end: one page mapped, the partial first page read
+    REQUIRE(storage.load(page / 2, fd, page / 2, bytes.size() - page / 2 - 8) == page);
+    REQUIRE(std::memcmp(data + page / 2, bytes.data() + page / 2, bytes.size() - page / 2 - 8) == 0);
+    REQUIRE(data[0] == 0);
+
+    // Offsets that disagree modulo the page size can only be read
+    PageStorage shifted(2 * page);
+    REQUIRE(shifted.load(0, fd, 1, 2 * page) == 0);
+    REQUIRE(std::memcmp(shifted.data(), bytes.data() + 1, 2 * page) == 0);
+
+    // Mapped pages are private
+    data[page] = 'x';
+    ::close(fd);
+    std::vector<char> reread(bytes.size());
+    std::ifstream(path, std::ios::binary).read(reread.data(), static_cast<std::streamsize>(reread.size()));
+    REQUIRE(reread == bytes);
+
+    REQUIRE_THROWS_AS(storage.load(page, fd, 0, 3 * page), std::runtime_error);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,22 @@
+#ifndef CPPGRAD_TESTS_PRECISION_HPP
+#define CPPGRAD_TESTS_PRECISION_HPP
+
+#include "bfloat16.hpp"
+
+// Absolute tolerance for results computed by BasicValue<T>; bfloat16 keeps only 8 significant bits
+template <typename T>
+constexpr double tolerance() {
+    return 1e-6;
+}
+
+template <>
+constexpr double tolerance<float>() {
+    return 1e-5;
+}
+
+template <>
+constexpr double tolerance<BFloat16>() {
+    return 5e-2;
+}
+
+#endif  // CPPGRAD_TESTS_PRECISION_HPP
@@ -0,0 +1,54 @@
+#include "simd.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Restores the detected level when a test is done with it
+class SimdLevelScope {
+   private:
+    SimdLevel previous_ = simd_level();
+
+   public:
+    explicit SimdLevelScope(SimdLevel level) noexcept { set_simd_level(level); }
+    ~SimdLevelScope() { set_simd_level(previous_); }
+};
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("SIMD kernels agree with the scalar loop", "[simd]", double, float) {
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        SimdLevelScope scope(level);
+        REQUIRE(static_cast<int>(simd_level()) <= static_cast<int>(supported_simd_level()));
+        for (size_t n : {0, 1, 3, 7, 8, 15, 16, 17, 31, 33, 100}) {
+            std::vector<TestType> x(n);
+            std::vector<TestType> y(n);
+            TestType expected_dot = 0;
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = TestType(std::sin(0.5 * i));
+                y[i] = TestType(std::cos(0.25 * i));
+                expected_dot += x[i] * y[i];
+            }
+            const double tol = std::is_same_v<TestType, float> ? 1e-4 : 1e-12;
+            REQUIRE(std::abs(simd_dot(x.data(), y.data(), n) - expected_dot) < tol);
+
+            std::vector<TestType> z = y;
+            simd_axpy(TestType(0.5), x.data(), z.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                REQUIRE(std::abs(z[i] - (y[i] + TestType(0.5) * x[i])) < tol);
+            }
+        }
+    }
+}
+
+TEST_CASE("SIMD level is clamped to what the CPU supports", "[simd]") {
+    SimdLevelScope scope(SimdLevel::AVX512);
+    REQUIRE(simd_level() == supported_simd_level());
+    set_simd_level(SimdLevel::Scalar);
+    REQUIRE(simd_level() == SimdLevel::Scalar);
+    REQUIRE(std::string(simd_level_name(SimdLevel::Scalar)) == "scalar");
+}
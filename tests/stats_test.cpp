@@ -0,0 +1,63 @@
+#include "stats.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <vector>
+
+#include "neuron.hpp"
+#include "thread_pool.hpp"
+#include "value.hpp"
+
+TEST_CASE("Step stats attribute graph building, backward and parameter copies", "[stats]") {
+    Neuron neuron(3);
+    std::vector<Value> x = {Value(1.0), Value(2.0), Value(3.0)};
+
+    StepStats step;
+    Value loss = (neuron(x) - Value(1.0)).pow(2.0);
+    loss.backward();
+    loss.backward(true);
+    loss.backward(true);
+    std::vector<Value> params = neuron.parameters();
+    EngineStats stats = step.stats();
+
+    if (!kStatsEnabled) {
+        REQUIRE(stats.nodes_created() == 0);
+        REQUIRE(stats.backward_calls == 0);
+        REQUIRE(stats.parameter_copies == 0);
+        return;
+    }
+    REQUIRE(stats.leaves_created == 1);  // The target; x existed before the step
+    REQUIRE(stats.ops_recorded == 3);    // linear+ReLU, -, pow
+    REQUIRE(stats.node_bytes > 0);
+    REQUIRE(stats.backward_calls == 3);
+    REQUIRE(stats.topo_sorts == 2);  // The third call reuses the cached topology
+    REQUIRE(stats.backward_nodes == 3 * 11);  // 4 weights, 3 inputs, the target and 3 ops per call
+    REQUIRE(stats.parameter_copies == 1);
+    REQUIRE(stats.parameters_copied == 4);
+    REQUIRE(step.report().find("ops=3 ") != std::string::npos);
+
+    step.restart();
+    REQUIRE(step.stats().ops_recorded == 0);
+}
+
+TEST_CASE("Stats count parallel backward and no-grad results", "[stats][parallel]") {
+    Value a(2.0);
+    Value b(3.0);
+    StepStats step;
+    {
+        NoGradGuard guard;
+        Value c = a * b;
+    }
+    Value d = a * b + a;
+    ThreadPool pool(2);
+    d.backward(pool);
+    EngineStats stats = step.stats();
+
+    if (!kStatsEnabled) {
+        REQUIRE(stats.nodes_created() == 0);
+        return;
+    }
+    REQUIRE(stats.leaves_created == 1);  // The no-grad product
+    REQUIRE(stats.ops_recorded == 2);
+    REQUIRE(stats.backward_calls == 1);
+    REQUIRE(stats.backward_nodes == 4);
+}
@@ -0,0 +1,181 @@
+#include "tensor.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstdint>
+
+#include "value.hpp"
+
+TEST_CASE("Tensor construction and metadata", "[tensor]") {
+    Tensor t({2, 3}, {1, 2, 3, 4, 5, 6});
+    REQUIRE(t.ndim() == 2);
+    REQUIRE(t.numel() == 6);
+    REQUIRE(t.strides() == std::vector<size_t>{3, 1});
+    REQUIRE(t.at({1, 0}) == 4.0);
+    REQUIRE(t.op() == "");
+    REQUIRE(reinterpret_cast<std::uintptr_t>(t.data()) % 64 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(t.grad()) % 64 == 0);
+    REQUIRE(t.str() == "Tensor(shape=[2, 3], op='')");
+}
+
+TEST_CASE("Tensor construction errors", "[tensor]") {
+    REQUIRE_THROWS_AS(Tensor({2, 2}, {1, 2, 3}), std::runtime_error);
+    Tensor t({2, 2}, 1.0);
+    REQUIRE_THROWS_AS(t.at({2, 0}), std::runtime_error);
+    REQUIRE_THROWS_AS(t.at({0}), std::runtime_error);
+    REQUIRE_THROWS_AS(t.item(), std::runtime_error);
+}
+
+TEST_CASE("Tensor elementwise arithmetic", "[tensor]") {
+    Tensor a({2, 2}, {1, 2, 3, 4});
+    Tensor b({2, 2}, {4, 3, 2, 1});
+    REQUIRE((a + b).at({1, 1}) == 5.0);
+    REQUIRE((a - b).at({0, 0}) == -3.0);
+    REQUIRE((a * b).at({0, 1}) == 6.0);
+    REQUIRE((a / b).at({1, 0}) == 1.5);
+    REQUIRE(a.pow(2.0).at({1, 1}) == 16.0);
+    REQUIRE((a - b).relu().at({0, 0}) == 0.0);
+    REQUIRE_THROWS_AS(a / Tensor({2, 2}, {1, 0, 1, 1}), std::runtime_error);
+    REQUIRE_THROWS_AS(Tensor({1}, {-4.0}).pow(0.5), std::runtime_error);
+}
+
+TEST_CASE("Tensor broadcasting", "[tensor]") {
+    Tensor a({2, 3}, {1, 2, 3, 4, 5, 6});
+    Tensor row({3}, {10, 20, 30});
+    Tensor scalar({}, {2.0});
+
+    Tensor c = a + row;
+    REQUIRE(c.at({1, 2}) == 36.0);
+    REQUIRE((row - a).at({1, 0}) == 6.0);
+    REQUIRE((a * scalar).at({0, 1}) == 4.0);
+    REQUIRE_THROWS_AS(a + Tensor({2}, 1.0), std::runtime_error);
+
+    (a * row).sum().backward();
+    REQUIRE(row.grad_at({0}) == 5.0);  // 1 + 4
+    REQUIRE(row.grad_at({2}) == 9.0);  // 3 + 6
+    REQUIRE(a.grad_at({1, 1}) == 20.0);
+}
+
+TEST_CASE("Tensor broadcasting ignores leading unit dimensions", "[tensor]") {
+    Tensor a({2, 3}, {1, 2, 3, 4, 5, 6});
+    Tensor row({1, 3}, {10, 20, 30});
+    Tensor c = a + row;
+    REQUIRE(c.shape() == std::vector<size_t>{2, 3});
+    REQUIRE(c.at({1, 2}) == 36.0);
+    (a * row).sum().backward();
+    REQUIRE(row.grad_at({0, 2}) == 9.0);
+
+    Tensor v({3}, {1, 2, 3});
+    Tensor one({1, 1}, {2.0});
+    Tensor d = v * one;
+    REQUIRE(d.shape() == std::vector<size_t>{1, 3});
+    REQUIRE(d.at({0, 2}) == 6.0);
+    REQUIRE((one - v).shape() == std::vector<size_t>{1, 3});
+
+    REQUIRE_THROWS_AS(a + Tensor({2, 1}, 1.0), std::runtime_error);
+}
+
+TEST_CASE("Tensor gradients match Value", "[tensor]") {
+    std::vector<double> xs = {0.5, -1.5, 2.0, 3.0};
+    std::vector<double> ys = {1.0, 2.0, -0.5, 0.25};
+
+    Tensor x({4}, xs);
+    Tensor y({4}, ys);
+    Tensor loss = ((x * y - x / y).relu() + y.pow(2.0)).mean();
+    loss.backward();
+
+    for (size_t i = 0; i < 4; ++i) {
+        Value vx(xs[i]);
+        Value vy(ys[i]);
+        Value vloss = ((vx * vy - vx / vy).relu() + vy.pow(2.0)) / Value(4.0);
+        vloss.backward();
+        REQUIRE(std::abs(x.grad()[i] - vx.grad()) < 1e-12);
+        REQUIRE(std::abs(y.grad()[i] - vy.grad()) < 1e-12);
+    }
+}
+
+TEST_CASE("Tensor matmul forward and backward", "[tensor]") {
+    Tensor a({2, 3}, {1, 2, 3, 4, 5, 6});
+    Tensor b({3, 2}, {7, 8, 9, 10, 11, 12});
+    Tensor c = a.matmul(b);
+    REQUIRE(c.shape() == std::vector<size_t>{2, 2});
+    REQUIRE(c.at({0, 0}) == 58.0);
+    REQUIRE(c.at({1, 1}) == 154.0);
+    REQUIRE(c.op() == "matmul");
+
+    c.backward();
+    // d(sum(a @ b))/da[i][p] = sum_j b[p][j]; d/db[p][j] = sum_i a[i][p]
+    REQUIRE(a.grad_at({0, 0}) == 15.0);
+    REQUIRE(a.grad_at({1, 2}) == 23.0);
+    REQUIRE(b.grad_at({0, 1}) == 5.0);
+    REQUIRE(b.grad_at({2, 0}) == 9.0);
+
+    REQUIRE_THROWS_AS(a.matmul(a), std::runtime_error);
+}
+
+TEST_CASE("Tensor transpose", "[tensor]") {
+    Tensor a({2, 3}, {1, 2, 3, 4, 5, 6});
+    Tensor t = a.transpose();
+    REQUIRE(t.shape() == std::vector<size_t>{3, 2});
+    REQUIRE(t.at({2, 1}) == 6.0);
+    (t * Tensor({2}, {1.0, 10.0})).sum().backward();
+    REQUIRE(a.grad_at({0, 2}) == 1.0);
+    REQUIRE(a.grad_at({1, 0}) == 10.0);
+}
+
+TEST_CASE("Tensor reductions", "[tensor]") {
+    Tensor a({2, 3}, {1, 2, 3, 4, 5, 6});
+    REQUIRE(a.sum().item() == 21.0);
+    REQUIRE(a.mean().item() == 3.5);
+
+    Tensor rows = a.sum(1);
+    REQUIRE(rows.shape() == std::vector<size_t>{2});
+    REQUIRE(rows.at({1}) == 15.0);
+    Tensor cols = a.sum(0);
+    REQUIRE(cols.shape() == std::vector<size_t>{3});
+    REQUIRE(cols.at({2}) == 9.0);
+
+    (cols * Tensor({3}, {1, 2, 3})).sum().backward();
+    REQUIRE(a.grad_at({1, 2}) == 3.0);
+    REQUIRE_THROWS_AS(a.sum(2), std::runtime_error);
+}
+
+TEST_CASE("Tensor records one node per op", "[tensor]") {
+    Tensor x({1000}, 1.0);
+    Tensor w({1000}, 2.0);
+    Tensor out = (x * w).sum();
+    REQUIRE(out.item() == 2000.0);
+    REQUIRE(out.op() == "sum");
+}
+
+TEST_CASE("Tensor interoperates with Value", "[tensor]") {
+    std::vector<Value> weights = {Value(1.0), Value(-2.0), Value(3.0)};
+    Tensor w = Tensor::from_values(weights);
+    REQUIRE(w.op() == "stack");
+    Tensor x({3}, {4, 5, 6});
+    (w * x).relu().sum().backward();
+    REQUIRE(weights[0].grad() == 4.0);
+    REQUIRE(weights[1].grad() == 0.0);  // -10 clamped by ReLU
+    REQUIRE(weights[2].grad() == 6.0);
+}
+
+TEST_CASE("Packed Values pass gradients on to their graphs", "[tensor]") {
+    Value a(2.0);
+    Value b(3.0);
+    Value product = a * b;
+    Value constant(5.0, false);
+    // `product` is packed directly and again inside the second element
+    Tensor t = Tensor::from_values({product, product + a, constant});
+    Tensor x({3}, {1, 10, 100});
+    (t * x).sum().backward();
+    REQUIRE(product.grad() == 11.0);
+    REQUIRE(a.grad() == 11.0 * 3.0 + 10.0);
+    REQUIRE(b.grad() == 11.0 * 2.0);
+    REQUIRE(constant.grad() == 0.0);
+
+    // Interior Value gradients restart on each backward, leaf gradients accumulate
+    t.zero_grad();
+    (t * x).sum().backward();
+    REQUIRE(product.grad() == 11.0);
+    REQUIRE(a.grad() == 2.0 * (11.0 * 3.0 + 10.0));
+}
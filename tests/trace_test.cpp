@@ -0,0 +1,109 @@
+#include "trace.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "expression.hpp"
+#include "neuron.hpp"
+#include "value.hpp"
+
+namespace {
+
+const TraceOpSummary* find_summary(const std::vector<TraceOpSummary>& summaries, TracePhase phase,
+                                   const std::string& name) {
+    for (const TraceOpSummary& summary : summaries) {
+        if (summary.phase == phase && summary.name == name) return &summary;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+TEST_CASE("Traces record forward and backward events per op", "[trace]") {
+    Neuron neuron(2);
+    std::vector<Value> x = {Value(1.0), Value(2.0)};
+
+    start_trace();
+    Value loss = (neuron(x) - Value(1.0)).pow(2.0) + Value(lazy(x[0]) * x[1]);
+    loss.backward();
+    stop_trace();
+    Value untraced = x[0] * x[1];
+
+    std::vector<TraceOpSummary> summaries = trace_summary();
+    if (!kTraceEnabled) {
+        REQUIRE(trace_event_count() == 0);
+        return;
+    }
+    // Forward: linear+ReLU, -, pow, fused, +; backward: the same five ops, the sort and the call itself
+    REQUIRE(trace_event_count() == 12);
+    REQUIRE(trace_dropped_events() == 0);
+    for (const char* op : {"linear+ReLU", "-", "pow", "fused", "+"}) {
+        REQUIRE(find_summary(summaries, TracePhase::Forward, op) != nullptr);
+        REQUIRE(find_summary(summaries, TracePhase::Backward, op)->count == 1);
+    }
+    REQUIRE(find_summary(summaries, TracePhase::Forward, "*") == nullptr);
+    REQUIRE(find_summary(summaries, TracePhase::Backward, "topological sort") != nullptr);
+    REQUIRE(find_summary(summaries, TracePhase::Scope, "backward") != nullptr);
+    for (size_t i = 1; i < summaries.size(); ++i) {
+        REQUIRE(summaries[i - 1].total_ns >= summaries[i].total_ns);
+    }
+
+    std::ostringstream full;
+    write_chrome_trace(full);
+    REQUIRE(full.str().find("{\"traceEvents\":[") == 0);
+    REQUIRE(full.str().find("\"name\":\"pow\",\"cat\":\"forward\",\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(full.str().find("\"node\":\"0x") != std::string::npos);
+    REQUIRE(full.str().find("\"aggregated\":false") != std::string::npos);
+
+    std::ostringstream aggregated;
+    write_chrome_trace(aggregated, 4);
+    REQUIRE(aggregated.str().find("\"count\":1") != std::string::npos);
+    REQUIRE(aggregated.str().find("\"node\"") == std::string::npos);
+    REQUIRE(aggregated.str().find("\"aggregated\":true") != std::string::npos);
+}
+
+TEST_CASE("Trace ring buffers keep the latest events", "[trace]") {
+    Value a(1.0);
+    start_trace(4);
+    Value sum = a;
+    for (int i = 0; i < 10; ++i) sum = sum + a;
+    stop_trace();
+
+    if (!kTraceEnabled) {
+        REQUIRE(trace_event_count() == 0);
+        return;
+    }
+    REQUIRE(trace_event_count() == 4);
+    REQUIRE(trace_dropped_events() == 6);
+
+    start_trace();  // A new trace starts empty
+    stop_trace();
+    REQUIRE(trace_event_count() == 0);
+}
+
+TEST_CASE("Trace scopes still open when the trace stops record nothing", "[trace]") {
+    start_trace();
+    {
+        TraceScope stopped(TracePhase::Scope, "stopped");
+        stop_trace();
+    }
+    REQUIRE(trace_event_count() == 0);
+
+    start_trace();
+    {
+        TraceScope restarted(TracePhase::Scope, "restarted");
+        start_trace();  // Discards the trace the scope opened in
+        TraceScope current(TracePhase::Scope, "current");
+    }
+    stop_trace();
+    const std::vector<TraceOpSummary> summaries = trace_summary();
+    REQUIRE(find_summary(summaries, TracePhase::Scope, "restarted") == nullptr);
+    if (!kTraceEnabled) {
+        REQUIRE(summaries.empty());
+        return;
+    }
+    REQUIRE(find_summary(summaries, TracePhase::Scope, "current") != nullptr);
+    REQUIRE(trace_event_count() == 1);
+}
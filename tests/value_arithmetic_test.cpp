@@ -1,261 +1,301 @@
 #include <catch2/catch_all.hpp>
 #include <cmath>
 
+#include "precision.hpp"
 #include "value.hpp"
 
 // Addition
-TEST_CASE("Value addition with positive numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value addition with positive numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b(3.0);
     Value c = a + b;
-    REQUIRE(std::abs(c.data() - 5.0) < 1e-6);
+    REQUIRE(std::abs(c.data() - 5.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value addition with positive and negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value addition with positive and negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(-1.0);
     Value e(1.0);
     Value f = d + e;
-    REQUIRE(std::abs(f.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(f.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value addition with zero values", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value addition with zero values", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(0.0);
     Value h(0.0);
     Value i = g + h;
-    REQUIRE(std::abs(i.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(i.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value addition with decimal numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value addition with decimal numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(1.5);
     Value k(2.5);
     Value l = j + k;
-    REQUIRE(std::abs(l.data() - 4.0) < 1e-6);
+    REQUIRE(std::abs(l.data() - 4.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value addition with negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value addition with negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.5);
     Value n(-2.5);
     Value o = m + n;
-    REQUIRE(std::abs(o.data() - (-5.0)) < 1e-6);
+    REQUIRE(std::abs(o.data() - (-5.0)) < tolerance<TestType>());
 }
 
-TEST_CASE("Value self addition", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value self addition", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a + a;
-    REQUIRE(std::abs(b.data() - 4.0) < 1e-6);
+    REQUIRE(std::abs(b.data() - 4.0) < tolerance<TestType>());
 }
 
 // Subtraction
-TEST_CASE("Value subtraction with positive numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value subtraction with positive numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b(3.0);
     Value c = a - b;
-    REQUIRE(std::abs(c.data() - (-1.0)) < 1e-6);
+    REQUIRE(std::abs(c.data() - (-1.0)) < tolerance<TestType>());
 }
 
-TEST_CASE("Value subtraction with positive and negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value subtraction with positive and negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(-1.0);
     Value e(1.0);
     Value f = d - e;
-    REQUIRE(std::abs(f.data() - (-2.0)) < 1e-6);
+    REQUIRE(std::abs(f.data() - (-2.0)) < tolerance<TestType>());
 }
 
-TEST_CASE("Value subtraction with zero values", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value subtraction with zero values", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(0.0);
     Value h(0.0);
     Value i = g - h;
-    REQUIRE(std::abs(i.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(i.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value subtraction with decimal numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value subtraction with decimal numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(1.5);
     Value k(2.5);
     Value l = j - k;
-    REQUIRE(std::abs(l.data() - (-1.0)) < 1e-6);
+    REQUIRE(std::abs(l.data() - (-1.0)) < tolerance<TestType>());
 }
 
-TEST_CASE("Value subtraction with negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value subtraction with negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.5);
     Value n(-2.5);
     Value o = m - n;
-    REQUIRE(std::abs(o.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(o.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value self subtraction", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value self subtraction", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a - a;
-    REQUIRE(std::abs(b.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(b.data() - 0.0) < tolerance<TestType>());
 }
 
 // Multiplication
-TEST_CASE("Value multiplication with positive numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value multiplication with positive numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b(3.0);
     Value c = a * b;
-    REQUIRE(std::abs(c.data() - 6.0) < 1e-6);
+    REQUIRE(std::abs(c.data() - 6.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value multiplication with positive and negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value multiplication with positive and negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(-1.0);
     Value e(1.0);
     Value f = d * e;
-    REQUIRE(std::abs(f.data() - (-1.0)) < 1e-6);
+    REQUIRE(std::abs(f.data() - (-1.0)) < tolerance<TestType>());
 }
 
-TEST_CASE("Value multiplication with zero values", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value multiplication with zero values", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(0.0);
     Value h(0.0);
     Value i = g * h;
-    REQUIRE(std::abs(i.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(i.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value multiplication with decimal numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value multiplication with decimal numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(1.5);
     Value k(2.5);
     Value l = j * k;
-    REQUIRE(std::abs(l.data() - 3.75) < 1e-6);
+    REQUIRE(std::abs(l.data() - 3.75) < tolerance<TestType>());
 }
 
-TEST_CASE("Value multiplication with negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value multiplication with negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.5);
     Value n(-2.5);
     Value o = m * n;
-    REQUIRE(std::abs(o.data() - 6.25) < 1e-6);
+    REQUIRE(std::abs(o.data() - 6.25) < tolerance<TestType>());
 }
 
-TEST_CASE("Value self multiplication", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value self multiplication", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(3.0);
     Value b = a * a;
-    REQUIRE(std::abs(b.data() - 9.0) < 1e-6);
+    REQUIRE(std::abs(b.data() - 9.0) < tolerance<TestType>());
 }
 
 // Division
-TEST_CASE("Value division with positive numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value division with positive numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(6.0);
     Value b(3.0);
     Value c = a / b;
-    REQUIRE(std::abs(c.data() - 2.0) < 1e-6);
+    REQUIRE(std::abs(c.data() - 2.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value division with positive and negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value division with positive and negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(-6.0);
     Value e(3.0);
     Value f = d / e;
-    REQUIRE(std::abs(f.data() - (-2.0)) < 1e-6);
+    REQUIRE(std::abs(f.data() - (-2.0)) < tolerance<TestType>());
 }
 
-TEST_CASE("Value division with decimal numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value division with decimal numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(7.5);
     Value h(2.5);
     Value i = g / h;
-    REQUIRE(std::abs(i.data() - 3.0) < 1e-6);
+    REQUIRE(std::abs(i.data() - 3.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value division with negative numbers", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value division with negative numbers", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(-7.5);
     Value k(-2.5);
     Value l = j / k;
-    REQUIRE(std::abs(l.data() - 3.0) < 1e-6);
+    REQUIRE(std::abs(l.data() - 3.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value division by zero", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value division by zero", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(1.0);
     Value n(0.0);
     REQUIRE_THROWS_AS(m / n, std::runtime_error);
 }
 
-TEST_CASE("Value self division", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value self division", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(4.0);
     Value b = a / a;
-    REQUIRE(std::abs(b.data() - 1.0) < 1e-6);
+    REQUIRE(std::abs(b.data() - 1.0) < tolerance<TestType>());
 }
 
 // Power
-TEST_CASE("Value power with positive exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with positive exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a.pow(3.0);
-    REQUIRE(std::abs(b.data() - 8.0) < 1e-6);
+    REQUIRE(std::abs(b.data() - 8.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with zero exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with zero exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value c(2.0);
     Value d = c.pow(0.0);
-    REQUIRE(std::abs(d.data() - 1.0) < 1e-6);
+    REQUIRE(std::abs(d.data() - 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with one exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with one exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value e(2.0);
     Value f = e.pow(1.0);
-    REQUIRE(std::abs(f.data() - 2.0) < 1e-6);
+    REQUIRE(std::abs(f.data() - 2.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with negative exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with negative exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(2.0);
     Value h = g.pow(-2.0);
-    REQUIRE(std::abs(h.data() - 0.25) < 1e-6);
+    REQUIRE(std::abs(h.data() - 0.25) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with decimal exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with decimal exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value i(4.0);
     Value j = i.pow(0.5);
-    REQUIRE(std::abs(j.data() - 2.0) < 1e-6);
+    REQUIRE(std::abs(j.data() - 2.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with negative base and integer exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with negative base and integer exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value k(-2.0);
     Value l = k.pow(3.0);
-    REQUIRE(std::abs(l.data() - (-8.0)) < 1e-6);
+    REQUIRE(std::abs(l.data() - (-8.0)) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with negative base and even exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with negative base and even exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.0);
     Value n = m.pow(2.0);
-    REQUIRE(std::abs(n.data() - 4.0) < 1e-6);
+    REQUIRE(std::abs(n.data() - 4.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with negative base and fractional exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with negative base and fractional exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value o(-4.0);
     REQUIRE_THROWS_AS(o.pow(0.5), std::runtime_error);
 }
 
-TEST_CASE("Value power with zero base and positive exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with zero base and positive exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value o(0.0);
     Value p = o.pow(3.0);
-    REQUIRE(std::abs(p.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(p.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value power with zero base and zero exponent", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value power with zero base and zero exponent", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value q(0.0);
     REQUIRE_THROWS_AS(q.pow(0.0), std::runtime_error);
 }
 
 // ReLU
-TEST_CASE("Value ReLU with positive number", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value ReLU with positive number", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a.relu();
-    REQUIRE(std::abs(b.data() - 2.0) < 1e-6);
+    REQUIRE(std::abs(b.data() - 2.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value ReLU with negative number", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value ReLU with negative number", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value c(-2.0);
     Value d = c.relu();
-    REQUIRE(std::abs(d.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(d.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value ReLU with zero", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value ReLU with zero", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value e(0.0);
     Value f = e.relu();
-    REQUIRE(std::abs(f.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(f.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value ReLU with positive decimal number", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value ReLU with positive decimal number", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(1.5);
     Value h = g.relu();
-    REQUIRE(std::abs(h.data() - 1.5) < 1e-6);
+    REQUIRE(std::abs(h.data() - 1.5) < tolerance<TestType>());
 }
 
-TEST_CASE("Value ReLU with negative decimal number", "[arithmetic]") {
+TEMPLATE_TEST_CASE("Value ReLU with negative decimal number", "[arithmetic]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value i(-1.5);
     Value j = i.relu();
-    REQUIRE(std::abs(j.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(j.data() - 0.0) < tolerance<TestType>());
 }
@@ -1,83 +1,106 @@
-#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
 #include <sstream>
 
+#include "precision.hpp"
 #include "value.hpp"
 
-TEST_CASE("Value construction and basic properties", "[construction]") {
+TEMPLATE_TEST_CASE("Value construction and basic properties", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v(3.14);
-    REQUIRE(std::abs(v.data() - 3.14) < 1e-6);
-    REQUIRE(std::abs(v.grad() - 0.0) < 1e-6);
+    REQUIRE(std::abs(v.data() - 3.14) < tolerance<TestType>());
+    REQUIRE(std::abs(v.grad() - 0.0) < tolerance<TestType>());
     REQUIRE(v.op() == "");
 }
 
-TEST_CASE("Value copy construction and assignment", "[construction]") {
+TEMPLATE_TEST_CASE("Value copy construction and assignment", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v1(3.14);
     Value v2 = v1;  // Copy construction
     Value v3(2.0);
     v3 = v1;  // Copy assignment
 
-    REQUIRE(std::abs(v1.data() - v2.data()) < 1e-6);
-    REQUIRE(std::abs(v1.data() - v3.data()) < 1e-6);
+    REQUIRE(std::abs(v1.data() - v2.data()) < tolerance<TestType>());
+    REQUIRE(std::abs(v1.data() - v3.data()) < tolerance<TestType>());
 
     // Modify original - gradients should propagate to copies
     v1.backward();
-    REQUIRE(std::abs(v2.grad() - v1.grad()) < 1e-6);  // v2 should be affected
-    REQUIRE(std::abs(v3.grad() - v1.grad()) < 1e-6);  // v3 should be affected
+    REQUIRE(std::abs(v2.grad() - v1.grad()) < tolerance<TestType>());  // v2 should be affected
+    REQUIRE(std::abs(v3.grad() - v1.grad()) < tolerance<TestType>());  // v3 should be affected
 }
 
-TEST_CASE("Value move construction and assignment", "[construction]") {
+TEMPLATE_TEST_CASE("Value move construction and assignment", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v1(3.14);
     Value v2 = std::move(Value(3.14));  // Move construction
     Value v3(2.0);
     v3 = std::move(Value(3.14));  // Move assignment
 
-    REQUIRE(std::abs(v2.data() - 3.14) < 1e-6);
-    REQUIRE(std::abs(v3.data() - 3.14) < 1e-6);
+    REQUIRE(std::abs(v2.data() - 3.14) < tolerance<TestType>());
+    REQUIRE(std::abs(v3.data() - 3.14) < tolerance<TestType>());
 }
 
-TEST_CASE("Value construction with operation info", "[construction]") {
+TEMPLATE_TEST_CASE("Value construction with operation info", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v1(2.0);
     Value v2(3.0);
     Value v3 = v1 + v2;
 
     REQUIRE(v3.op() == "+");
-    REQUIRE(std::abs(v3.data() - 5.0) < 1e-6);
+    REQUIRE(std::abs(v3.data() - 5.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value construction with zero", "[construction]") {
+TEMPLATE_TEST_CASE("Value construction with zero", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v(0.0);
-    REQUIRE(std::abs(v.data() - 0.0) < 1e-6);
-    REQUIRE(std::abs(v.grad() - 0.0) < 1e-6);
+    REQUIRE(std::abs(v.data() - 0.0) < tolerance<TestType>());
+    REQUIRE(std::abs(v.grad() - 0.0) < tolerance<TestType>());
     REQUIRE(v.op() == "");
 }
 
-TEST_CASE("Value construction with negative numbers", "[construction]") {
+TEMPLATE_TEST_CASE("Value construction with negative numbers", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v(-3.14);
-    REQUIRE(std::abs(v.data() + 3.14) < 1e-6);
-    REQUIRE(std::abs(v.grad() - 0.0) < 1e-6);
+    REQUIRE(std::abs(v.data() + 3.14) < tolerance<TestType>());
+    REQUIRE(std::abs(v.grad() - 0.0) < tolerance<TestType>());
     REQUIRE(v.op() == "");
 }
 
-TEST_CASE("Value data setter", "[construction]") {
+TEMPLATE_TEST_CASE("Value data setter", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v(1.0);
     v.set_data(2.5);
-    REQUIRE(std::abs(v.data() - 2.5) < 1e-6);
+    REQUIRE(std::abs(v.data() - 2.5) < tolerance<TestType>());
 
     v.set_data(-3.14);
-    REQUIRE(std::abs(v.data() + 3.14) < 1e-6);
+    REQUIRE(std::abs(v.data() + 3.14) < tolerance<TestType>());
 
     v.set_data(0.0);
-    REQUIRE(std::abs(v.data() - 0.0) < 1e-6);
+    REQUIRE(std::abs(v.data() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Value gradient setter", "[construction]") {
+TEMPLATE_TEST_CASE("Value gradient setter", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value v(1.0);
     v.set_grad(1.0);
-    REQUIRE(std::abs(v.grad() - 1.0) < 1e-6);
+    REQUIRE(std::abs(v.grad() - 1.0) < tolerance<TestType>());
 
     v.set_grad(-2.5);
-    REQUIRE(std::abs(v.grad() + 2.5) < 1e-6);
+    REQUIRE(std::abs(v.grad() + 2.5) < tolerance<TestType>());
 
     v.set_grad(0.0);
-    REQUIRE(std::abs(v.grad() - 0.0) < 1e-6);
+    REQUIRE(std::abs(v.grad() - 0.0) < tolerance<TestType>());
+}
+
+TEMPLATE_TEST_CASE("Value operation names", "[construction]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    Value a(2.0);
+    Value b(4.0);
+    REQUIRE(a.opcode() == Value::Op::Leaf);
+    REQUIRE((a - b).op() == "-");
+    REQUIRE((a * b).op() == "*");
+    REQUIRE((a / b).op() == "/");
+    REQUIRE(a.pow(3.0).op() == "pow");
+    REQUIRE(a.relu().op() == "ReLU");
+    REQUIRE(Value::linear({a, b}, {a}).opcode() == Value::Op::Linear);
+    REQUIRE(Value::linear({a, b}, {a}, true).op() == "linear+ReLU");
 }
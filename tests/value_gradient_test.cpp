@@ -1,308 +1,398 @@
 #include <catch2/catch_all.hpp>
 #include <cmath>
+#include <stdexcept>
+#include <vector>
 
+#include "precision.hpp"
 #include "value.hpp"
 
 // Addition
-TEST_CASE("Gradient computation for addition with positive numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for addition with positive numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b(3.0);
     Value c = a + b;
     c.backward();
-    REQUIRE(std::abs(a.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(b.grad() - 1.0) < 1e-6);
+    REQUIRE(std::abs(a.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(b.grad() - 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for addition with positive and negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for addition with positive and negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(-1.0);
     Value e(1.0);
     Value f = d + e;
     f.backward();
-    REQUIRE(std::abs(d.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(e.grad() - 1.0) < 1e-6);
+    REQUIRE(std::abs(d.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(e.grad() - 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for addition with zero values", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for addition with zero values", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(0.0);
     Value h(0.0);
     Value i = g + h;
     i.backward();
-    REQUIRE(std::abs(g.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(h.grad() - 1.0) < 1e-6);
+    REQUIRE(std::abs(g.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(h.grad() - 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for addition with decimal numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for addition with decimal numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(1.5);
     Value k(2.5);
     Value l = j + k;
     l.backward();
-    REQUIRE(std::abs(j.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(k.grad() - 1.0) < 1e-6);
+    REQUIRE(std::abs(j.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(k.grad() - 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for addition with negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for addition with negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.5);
     Value n(-2.5);
     Value o = m + n;
     o.backward();
-    REQUIRE(std::abs(m.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(n.grad() - 1.0) < 1e-6);
+    REQUIRE(std::abs(m.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(n.grad() - 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for self addition", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for self addition", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a + a;  // b = 2.0 + 2.0 = 4.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 2.0) < 1e-6);  // gradient should be 2.0 because a is used twice
+    REQUIRE(std::abs(a.grad() - 2.0) < tolerance<TestType>());  // gradient should be 2.0 because a is used twice
 }
 
 // Subtraction
-TEST_CASE("Gradient computation for subtraction with positive numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for subtraction with positive numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(5.0);
     Value b(3.0);
     Value c = a - b;
     c.backward();
-    REQUIRE(std::abs(a.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(b.grad() + 1.0) < 1e-6);
+    REQUIRE(std::abs(a.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(b.grad() + 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for subtraction with positive and negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for subtraction with positive and negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(1.0);
     Value e(-1.0);
     Value f = d - e;
     f.backward();
-    REQUIRE(std::abs(d.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(e.grad() + 1.0) < 1e-6);
+    REQUIRE(std::abs(d.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(e.grad() + 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for subtraction with zero values", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for subtraction with zero values", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(0.0);
     Value h(0.0);
     Value i = g - h;
     i.backward();
-    REQUIRE(std::abs(g.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(h.grad() + 1.0) < 1e-6);
+    REQUIRE(std::abs(g.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(h.grad() + 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for subtraction with decimal numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for subtraction with decimal numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(2.5);
     Value k(1.5);
     Value l = j - k;
     l.backward();
-    REQUIRE(std::abs(j.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(k.grad() + 1.0) < 1e-6);
+    REQUIRE(std::abs(j.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(k.grad() + 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for subtraction with negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for subtraction with negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.5);
     Value n(-1.5);
     Value o = m - n;
     o.backward();
-    REQUIRE(std::abs(m.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(n.grad() + 1.0) < 1e-6);
+    REQUIRE(std::abs(m.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(n.grad() + 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for self subtraction", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for self subtraction", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a - a;  // b = 2.0 - 2.0 = 0.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.0) < 1e-6);  // gradient should be 0.0 because effects cancel out
+    REQUIRE(std::abs(a.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0.0 because effects cancel out
 }
 
 // Multiplication
-TEST_CASE("Gradient computation for multiplication with positive numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for multiplication with positive numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b(3.0);
     Value c = a * b;
     c.backward();
-    REQUIRE(std::abs(a.grad() - 3.0) < 1e-6);
-    REQUIRE(std::abs(b.grad() - 2.0) < 1e-6);
+    REQUIRE(std::abs(a.grad() - 3.0) < tolerance<TestType>());
+    REQUIRE(std::abs(b.grad() - 2.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for multiplication with positive and negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for multiplication with positive and negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(-1.0);
     Value e(1.0);
     Value f = d * e;
     f.backward();
-    REQUIRE(std::abs(d.grad() - 1.0) < 1e-6);
-    REQUIRE(std::abs(e.grad() + 1.0) < 1e-6);
+    REQUIRE(std::abs(d.grad() - 1.0) < tolerance<TestType>());
+    REQUIRE(std::abs(e.grad() + 1.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for multiplication with zero values", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for multiplication with zero values", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(0.0);
     Value h(2.0);
     Value i = g * h;
     i.backward();
-    REQUIRE(std::abs(g.grad() - 2.0) < 1e-6);
-    REQUIRE(std::abs(h.grad() - 0.0) < 1e-6);
+    REQUIRE(std::abs(g.grad() - 2.0) < tolerance<TestType>());
+    REQUIRE(std::abs(h.grad() - 0.0) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for multiplication with decimal numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for multiplication with decimal numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(1.5);
     Value k(2.5);
     Value l = j * k;
     l.backward();
-    REQUIRE(std::abs(j.grad() - 2.5) < 1e-6);
-    REQUIRE(std::abs(k.grad() - 1.5) < 1e-6);
+    REQUIRE(std::abs(j.grad() - 2.5) < tolerance<TestType>());
+    REQUIRE(std::abs(k.grad() - 1.5) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for multiplication with negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for multiplication with negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.5);
     Value n(-2.5);
     Value o = m * n;
     o.backward();
-    REQUIRE(std::abs(m.grad() + 2.5) < 1e-6);
-    REQUIRE(std::abs(n.grad() + 2.5) < 1e-6);
+    REQUIRE(std::abs(m.grad() + 2.5) < tolerance<TestType>());
+    REQUIRE(std::abs(n.grad() + 2.5) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for self multiplication", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for self multiplication", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(3.0);
     Value b = a * a;  // b = 3.0 * 3.0 = 9.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 6.0) < 1e-6);  // gradient should be 2 * a
+    REQUIRE(std::abs(a.grad() - 6.0) < tolerance<TestType>());  // gradient should be 2 * a
 }
 
 // Division
-TEST_CASE("Gradient computation for division with positive numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for division with positive numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(6.0);
     Value b(3.0);
     Value c = a / b;
     c.backward();
-    REQUIRE(std::abs(a.grad() - (1.0 / b.data())) < 1e-6);
-    REQUIRE(std::abs(b.grad() + (a.data() / (b.data() * b.data()))) < 1e-6);
+    REQUIRE(std::abs(a.grad() - (1.0 / b.data())) < tolerance<TestType>());
+    REQUIRE(std::abs(b.grad() + (a.data() / (b.data() * b.data()))) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for division with positive and negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for division with positive and negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value d(-6.0);
     Value e(3.0);
     Value f = d / e;
     f.backward();
-    REQUIRE(std::abs(d.grad() - (1.0 / e.data())) < 1e-6);
-    REQUIRE(std::abs(e.grad() + (d.data() / (e.data() * e.data()))) < 1e-6);
+    REQUIRE(std::abs(d.grad() - (1.0 / e.data())) < tolerance<TestType>());
+    REQUIRE(std::abs(e.grad() + (d.data() / (e.data() * e.data()))) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for division with zero numerator", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for division with zero numerator", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value g(0.0);
     Value h(2.0);
     Value i = g / h;
     i.backward();
-    REQUIRE(std::abs(g.grad() - (1.0 / h.data())) < 1e-6);
-    REQUIRE(std::abs(h.grad() + (g.data() / (h.data() * h.data()))) < 1e-6);
+    REQUIRE(std::abs(g.grad() - (1.0 / h.data())) < tolerance<TestType>());
+    REQUIRE(std::abs(h.grad() + (g.data() / (h.data() * h.data()))) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for division with decimal numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for division with decimal numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value j(2.5);
     Value k(1.5);
     Value l = j / k;
     l.backward();
-    REQUIRE(std::abs(j.grad() - (1.0 / k.data())) < 1e-6);
-    REQUIRE(std::abs(k.grad() + (j.data() / (k.data() * k.data()))) < 1e-6);
+    REQUIRE(std::abs(j.grad() - (1.0 / k.data())) < tolerance<TestType>());
+    REQUIRE(std::abs(k.grad() + (j.data() / (k.data() * k.data()))) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for division with negative numbers", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for division with negative numbers", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value m(-2.5);
     Value n(-1.5);
     Value o = m / n;
     o.backward();
-    REQUIRE(std::abs(m.grad() - (1.0 / n.data())) < 1e-6);
-    REQUIRE(std::abs(n.grad() + (m.data() / (n.data() * n.data()))) < 1e-6);
+    REQUIRE(std::abs(m.grad() - (1.0 / n.data())) < tolerance<TestType>());
+    REQUIRE(std::abs(n.grad() + (m.data() / (n.data() * n.data()))) < tolerance<TestType>());
 }
 
-TEST_CASE("Gradient computation for self division", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for self division", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(4.0);
     Value b = a / a;  // b = 4.0 / 4.0 = 1.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.0) < 1e-6);  // gradient should be 0 because effects cancel out
+    REQUIRE(std::abs(a.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0 because effects cancel out
 }
 
 // Pow
-TEST_CASE("Gradient computation for power with positive base and positive exponent", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for power with positive base and positive exponent", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a.pow(3.0);  // b = 2.0^3.0 = 8.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 12.0) < 1e-6);  // gradient should be 3 * 2.0^2.0 = 12.0
+    REQUIRE(std::abs(a.grad() - 12.0) < tolerance<TestType>());  // gradient should be 3 * 2.0^2.0 = 12.0
 }
 
-TEST_CASE("Gradient computation for power with positive base and negative exponent", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for power with positive base and negative exponent", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a.pow(-2.0);  // b = 2.0^(-2.0) = 0.25
     b.backward();
-    REQUIRE(std::abs(a.grad() + 0.25) < 1e-6);  // gradient should be -2 * 2.0^(-3.0) = -0.25
+    REQUIRE(std::abs(a.grad() + 0.25) < tolerance<TestType>());  // gradient should be -2 * 2.0^(-3.0) = -0.25
 }
 
-TEST_CASE("Gradient computation for power with negative base and positive exponent", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for power with negative base and positive exponent", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(-2.0);
     Value b = a.pow(3.0);  // b = (-2.0)^3.0 = -8.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 12.0) < 1e-6);  // gradient should be 3 * (-2.0)^2.0 = 12.0
+    REQUIRE(std::abs(a.grad() - 12.0) < tolerance<TestType>());  // gradient should be 3 * (-2.0)^2.0 = 12.0
 }
 
-TEST_CASE("Gradient computation for power with negative base and negative exponent", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for power with negative base and negative exponent", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(-2.0);
     Value b = a.pow(-2.0);  // b = (-2.0)^(-2.0) = 0.25
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.25) < 1e-6);  // gradient should be -2 * (-2.0)^(-3.0) = 0.25
+    REQUIRE(std::abs(a.grad() - 0.25) < tolerance<TestType>());  // gradient should be -2 * (-2.0)^(-3.0) = 0.25
 }
 
-TEST_CASE("Gradient computation for power with zero base and positive exponent", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for power with zero base and positive exponent", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(0.0);
     Value b = a.pow(3.0);  // b = 0.0^3.0 = 0.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.0) < 1e-6);  // gradient should be 3 * 0.0^2.0 = 0.0
+    REQUIRE(std::abs(a.grad() - 0.0) < tolerance<TestType>());  // gradient should be 3 * 0.0^2.0 = 0.0
 }
 
-TEST_CASE("Gradient computation for power with positive base and zero exponent", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for power with positive base and zero exponent", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a.pow(0.0);  // b = 2.0^0.0 = 1.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.0) < 1e-6);  // gradient should be 0 because exponent is 0
+    REQUIRE(std::abs(a.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0 because exponent is 0
 }
 
-TEST_CASE("Gradient computation for power with positive base and fractional exponent", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for power with positive base and fractional exponent", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(4.0);
     Value b = a.pow(0.5);  // b = 4.0^0.5 = 2.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.25) < 1e-6);  // gradient should be 0.5 * 4.0^(-0.5) = 0.25
+    REQUIRE(std::abs(a.grad() - 0.25) < tolerance<TestType>());  // gradient should be 0.5 * 4.0^(-0.5) = 0.25
 }
 
 // ReLU
-TEST_CASE("Gradient computation for ReLU with positive input", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for ReLU with positive input", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(2.0);
     Value b = a.relu();  // b = ReLU(2.0) = 2.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 1.0) < 1e-6);  // gradient should be 1 because input is positive
+    REQUIRE(std::abs(a.grad() - 1.0) < tolerance<TestType>());  // gradient should be 1 because input is positive
 }
 
-TEST_CASE("Gradient computation for ReLU with negative input", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for ReLU with negative input", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(-2.0);
     Value b = a.relu();  // b = ReLU(-2.0) = 0.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.0) < 1e-6);  // gradient should be 0 because input is negative
+    REQUIRE(std::abs(a.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0 because input is negative
 }
 
-TEST_CASE("Gradient computation for ReLU with zero input", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for ReLU with zero input", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(0.0);
     Value b = a.relu();  // b = ReLU(0.0) = 0.0
     b.backward();
-    REQUIRE(std::abs(a.grad() - 0.0) < 1e-6);  // gradient should be 0 because input is zero
+    REQUIRE(std::abs(a.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0 because input is zero
 }
 
-TEST_CASE("Gradient computation for ReLU with positive and negative inputs", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for ReLU with positive and negative inputs", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(1.0);
     Value b(-1.0);
     Value c = a.relu() + b.relu();  // c = ReLU(1.0) + ReLU(-1.0) = 1.0 + 0.0 = 1.0
     c.backward();
-    REQUIRE(std::abs(a.grad() - 1.0) < 1e-6);  // gradient should be 1 for positive input
-    REQUIRE(std::abs(b.grad() - 0.0) < 1e-6);  // gradient should be 0 for negative input
+    REQUIRE(std::abs(a.grad() - 1.0) < tolerance<TestType>());  // gradient should be 1 for positive input
+    REQUIRE(std::abs(b.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0 for negative input
 }
 
-TEST_CASE("Gradient computation for ReLU with mixed inputs", "[gradient]") {
+TEMPLATE_TEST_CASE("Gradient computation for ReLU with mixed inputs", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
     Value a(1.0);
     Value b(0.0);
     Value c(-1.0);
     Value d = a.relu() + b.relu() + c.relu();  // d = ReLU(1.0) + ReLU(0.0) + ReLU(-1.0) = 1.0 + 0.0 + 0.0 = 1.0
     d.backward();
-    REQUIRE(std::abs(a.grad() - 1.0) < 1e-6);  // gradient should be 1 for positive input
-    REQUIRE(std::abs(b.grad() - 0.0) < 1e-6);  // gradient should be 0 for zero input
-    REQUIRE(std::abs(c.grad() - 0.0) < 1e-6);  // gradient should be 0 for negative input
+    REQUIRE(std::abs(a.grad() - 1.0) < tolerance<TestType>());  // gradient should be 1 for positive input
+    REQUIRE(std::abs(b.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0 for zero input
+    REQUIRE(std::abs(c.grad() - 0.0) < tolerance<TestType>());  // gradient should be 0 for negative input
+}
+
+// Graph traversal
+TEMPLATE_TEST_CASE("Gradient computation for shared subexpressions", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    Value a(2.0);
+    Value b = a * a;
+    Value c = b + b * a;  // c = a^2 + a^3
+    c.backward();
+    REQUIRE(std::abs(a.grad() - 16.0) < tolerance<TestType>());  // 2a + 3a^2
+}
+
+TEMPLATE_TEST_CASE("Gradient computation with a reused topological order", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    Value a(2.0);
+    Value b(3.0);
+    Value cached = (a * b).relu() + a / b;
+    Value c(2.0);
+    Value d(3.0);
+    Value uncached = (c * d).relu() + c / d;
+
+    for (int i = 0; i < 3; ++i) {
+        cached.backward(true);
+        uncached.backward();
+        REQUIRE(a.grad() == c.grad());
+        REQUIRE(b.grad() == d.grad());
+    }
+}
+
+TEST_CASE("Gradient computation from several roots at once", "[gradient]") {
+    Value a(2.0);
+    Value b(3.0);
+    Value product = a * b;
+    Value sum = product + a;
+    std::vector<double> grads = {1.0, 10.0};
+    Value::backward_from({product, sum}, Span<const double>(grads.data(), grads.size()));
+    REQUIRE(a.grad() == 11.0 * 3.0 + 10.0);
+    REQUIRE(b.grad() == 11.0 * 2.0);
+
+    REQUIRE_THROWS_AS(Value::backward_from({product, sum}, Span<const double>(grads.data(), 1)), std::runtime_error);
+}
+
+TEMPLATE_TEST_CASE("Gradient computation for a very deep graph", "[gradient]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    Value x(1.0);
+    Value sum(0.0);
+    for (int i = 0; i < 1000000; ++i) {
+        sum = sum + x;
+    }
+    sum.backward();
+    REQUIRE(std::abs(x.grad() - 1000000.0) < tolerance<TestType>());
 }
@@ -0,0 +1,55 @@
+#include <sys/resource.h>
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <vector>
+
+#include "neuron.hpp"
+#include "value.hpp"
+
+namespace {
+
+long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+double train_step(Neuron& neuron) {
+    std::vector<Value> inputs = {Value(0.5), Value(-1.5), Value(2.0)};
+    Value loss = (neuron(inputs) - Value(1.0)).pow(2.0);
+    loss.backward();
+    return loss.data();
+}
+
+}  // namespace
+
+TEST_CASE("Backward through temporaries", "[memory]") {
+    Neuron n(2, false);
+    auto params = n.parameters();
+    params[0].set_data(2.0);
+    params[1].set_data(-1.0);
+    params[2].set_data(0.5);
+
+    Value x0(3.0);
+    Value x1(4.0);
+    Value out = n({x0, x1}) * Value(2.0);
+    out.backward();
+    REQUIRE(std::abs(params[0].grad() - 6.0) < 1e-6);
+    REQUIRE(std::abs(params[1].grad() - 8.0) < 1e-6);
+    REQUIRE(std::abs(params[2].grad() - 2.0) < 1e-6);
+    REQUIRE(std::abs(x0.grad() - 4.0) < 1e-6);
+    REQUIRE(std::abs(x1.grad() + 2.0) < 1e-6);
+}
+
+TEST_CASE("Graphs are freed once unreachable", "[memory]") {
+    Neuron n(3);
+    for (int i = 0; i < 10000; ++i) train_step(n);  // warm up the allocator
+    const long baseline = peak_rss_kb();
+
+    double sink = 0.0;
+    for (int i = 0; i < 2000000; ++i) sink += train_step(n);
+
+    REQUIRE(std::isfinite(sink));
+    REQUIRE(peak_rss_kb() - baseline < 4096);  // a leak would cost hundreds of MB here
+}
@@ -0,0 +1,59 @@
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <vector>
+
+#include "arena.hpp"
+#include "neuron.hpp"
+#include "precision.hpp"
+#include "value.hpp"
+
+TEMPLATE_TEST_CASE("No-grad ops compute the forward value only", "[no_grad]", double, float, BFloat16) {
+    using Value = BasicValue<TestType>;
+    Value a(2.0);
+    Value b(3.0);
+    Value graph = ((a * b + a / b - b).pow(2.0)).relu();
+
+    NoGradGuard guard;
+    Value c = ((a * b + a / b - b).pow(2.0)).relu();
+    REQUIRE(std::abs(c.data() - graph.data()) < tolerance<TestType>());
+    REQUIRE(c.opcode() == Value::Op::Leaf);
+
+    c.backward();
+    REQUIRE(a.grad() == 0.0);
+    REQUIRE(b.grad() == 0.0);
+}
+
+TEST_CASE("No-grad guards nest and restore the previous mode", "[no_grad]") {
+    REQUIRE_FALSE(NoGradGuard::active());
+    {
+        NoGradGuard outer;
+        {
+            NoGradGuard inner;
+            REQUIRE(NoGradGuard::active());
+        }
+        REQUIRE(NoGradGuard::active());
+    }
+    REQUIRE_FALSE(NoGradGuard::active());
+
+    Value a(2.0);
+    Value b = a * a;
+    b.backward();
+    REQUIRE(std::abs(a.grad() - 4.0) < 1e-6);
+}
+
+TEST_CASE("No-grad neuron prediction matches and allocates a single node", "[no_grad]") {
+    Neuron neuron(8);
+    std::vector<Value> inputs;
+    for (int i = 0; i < 8; ++i) {
+        inputs.emplace_back(std::sin(static_cast<double>(i)));
+    }
+    Value expected = neuron(inputs);
+
+    GraphArena arena;
+    NoLeakScope scope(arena);
+    NoGradGuard guard;
+    Value prediction = neuron(inputs);
+    REQUIRE(prediction.data() == expected.data());
+    REQUIRE(prediction.opcode() == Value::Op::Leaf);
+    REQUIRE(arena.live_allocations() == 1);
+}
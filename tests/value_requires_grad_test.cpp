@@ -0,0 +1,84 @@
+#include <catch2/catch_all.hpp>
+#include <vector>
+
+#include "neuron.hpp"
+#include "thread_pool.hpp"
+#include "value.hpp"
+
+TEST_CASE("requires_grad propagates through ops", "[requires_grad]") {
+    Value x(2.0, false);
+    Value w(3.0);
+    REQUIRE_FALSE(x.requires_grad());
+    REQUIRE(w.requires_grad());
+
+    REQUIRE_FALSE((x * x + x).pow(2.0).requires_grad());
+    REQUIRE((x * x + w).relu().requires_grad());
+    REQUIRE(Value::linear({w, Value(1.0, false)}, {x}).requires_grad());
+    REQUIRE_FALSE(Value::linear({x, x}, {x}).requires_grad());
+
+    w.set_requires_grad(false);
+    REQUIRE_FALSE((w * x).requires_grad());
+}
+
+TEST_CASE("Backward skips subgraphs without a trainable leaf", "[requires_grad]") {
+    Value x(2.0, false);
+    Value label(1.0, false);
+    Value w(3.0);
+    Value features = (x * x - label).pow(2.0);  // 9, requires no grad
+    Value loss = w * features + (w * x - label);
+    loss.backward();
+
+    REQUIRE(w.grad() == 11.0);  // features + x
+    REQUIRE(x.grad() == 0.0);
+    REQUIRE(label.grad() == 0.0);
+    REQUIRE(features.grad() == 0.0);
+}
+
+TEMPLATE_TEST_CASE("Trainable gradients do not depend on the inputs requiring grad", "[requires_grad]", double, float,
+                   BFloat16) {
+    using Value = BasicValue<TestType>;
+    BasicNeuron<TestType> neuron(4);
+    for (const Value& p : neuron.parameters()) REQUIRE(p.requires_grad());
+
+    auto run = [&](bool inputs_require_grad) {
+        std::vector<Value> x;
+        for (int i = 0; i < 4; ++i) x.emplace_back(0.25 * i - 0.4, inputs_require_grad);
+        std::vector<Value> normalized;
+        for (const Value& xi : x) normalized.push_back((xi - x[0]) / Value(2.0, inputs_require_grad));
+
+        for (Value& p : neuron.parameters()) p.set_grad(0.0);
+        Value out = (neuron(normalized) - Value(1.0, false)).pow(2.0);
+        REQUIRE(out.requires_grad());
+        out.backward();
+
+        std::vector<double> grads;
+        for (const Value& p : neuron.parameters()) grads.push_back(p.grad());
+        return grads;
+    };
+    REQUIRE(run(false) == run(true));
+}
+
+TEST_CASE("Parallel backward skips subgraphs without a trainable leaf", "[requires_grad][parallel]") {
+    ThreadPool pool(4);
+    Neuron neuron(32);
+    std::vector<Value> x;
+    for (int i = 0; i < 32; ++i) x.emplace_back(0.1 * i, false);
+    std::vector<Value> features;
+    for (const Value& xi : x) features.push_back((xi * xi).relu());
+
+    Value serial = neuron(features);
+    serial.backward();
+    std::vector<double> expected;
+    for (Value& p : neuron.parameters()) {
+        expected.push_back(p.grad());
+        p.set_grad(0.0);
+    }
+
+    Value parallel = neuron(features);
+    parallel.backward(pool);
+    std::vector<Value> params = neuron.parameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+        REQUIRE(params[i].grad() == expected[i]);
+    }
+    for (const Value& xi : x) REQUIRE(xi.grad() == 0.0);
+}